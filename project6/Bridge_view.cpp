@@ -2,10 +2,10 @@
 #include "Geometry.h"
 #include "Navigation.h"
 #include "Utility.h"
+#include "Output.h"
 #include <iostream>
 #include <vector>
 
-using std::cout;
 using std::endl;
 using std::string;
 using std::vector;
@@ -34,6 +34,17 @@ void Bridge_view::update_location(const string& name, Point location) {
         ship_location = location;
 }
 
+// Save the locations of many objects at once, and follow the ship if it is among them
+void Bridge_view::update_states(const std::vector<Object_state>& states) {
+    Grid_view::update_states(states);
+    for (const auto& state : states) {
+        if (state.name == ship_name) {
+            update_location(state.name, state.location);
+            update_course(state.name, state.course);
+        }
+    }
+}
+
 // change the state to sunk if name is the bridge view name
 void Bridge_view::update_remove(const string& name) {
     Grid_view::update_remove(name);
@@ -49,12 +60,12 @@ void Bridge_view::save(std::ostream &os) const {
 }
 
 // Print size, scale, and origin
-void Bridge_view::print_map_info(vector<string> outsider) const {
-    cout << "Bridge view from " << ship_name;
+void Bridge_view::print_map_info(const vector<string>& drawn, int outsider_count) const {
+    out << "Bridge view from " << ship_name;
     if (is_sunk)
-        cout << " sunk at " << ship_location << endl;
+        out << " sunk at " << ship_location << endl;
     else
-        cout << " position " << ship_location << " heading " << ship_heading << endl;
+        out << " position " << ship_location << " heading " << ship_heading << endl;
 }
 
 // Transform ship's location to relative location in the map
@@ -72,6 +83,11 @@ Point Bridge_view::get_relative_location(Point location) const {
     return Point{bearing, 0};
 }
 
+// only objects within 20 nm of the ship can show up on the bridge view
+void Bridge_view::get_viewport(Point& lower_left, Point& upper_right) const {
+    lower_left = Point(ship_location.x - 20., ship_location.y - 20.);
+    upper_right = Point(ship_location.x + 20., ship_location.y + 20.);
+}
 
 // return an initialized grid map
 vector<vector<string>> Bridge_view::get_initial_map() const {
@@ -80,7 +96,7 @@ vector<vector<string>> Bridge_view::get_initial_map() const {
 
 // draw y label
 void Bridge_view::draw_y_label(int y_index) const {
-    cout << "     ";
+    out << "     ";
 }
 
 // if ship is sunk, we don't need to update the grid map.
@@ -5,7 +5,6 @@
 #include <vector>
 #include <string>
 
-struct Point;
 
 class Bridge_view : public Grid_view {
 public:
@@ -18,6 +17,9 @@ public:
     // Save the supplied name and location for future use in a draw() call
     void update_location(const std::string& name, Point location) override;
     
+    // Save the locations of many objects at once, and follow the ship if it is among them
+    void update_states(const std::vector<Object_state>& states) override;
+    
     // Update view to sunk view.
     void update_remove(const std::string& name) override;
    
@@ -28,8 +30,10 @@ public:
     
 private:
     /* Helper Function */
-    void print_map_info(std::vector<std::string> outsider) const override;
+    void print_map_info(const std::vector<std::string>& drawn,
+                        int outsider_count) const override;
     Point get_relative_location(Point location) const override;
+    void get_viewport(Point& lower_left, Point& upper_right) const override;
     std::vector<std::vector<std::string>> get_initial_map() const override;
     void draw_y_label(int y_index) const override;
     void update_map(std::vector<std::vector<std::string>>& grid_map,
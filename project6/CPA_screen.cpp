@@ -0,0 +1,244 @@
+#include "CPA_screen.h"
+#include "Track_base.h"
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using std::vector;
+using std::unordered_map;
+using std::min;
+using std::max;
+
+// Candidate pairs in structure-of-arrays form, ready for the narrowphase
+struct Candidates {
+    vector<int> first, second;
+    vector<double> rx, ry;      // relative position of second from first
+    vector<double> rvx, rvy;    // relative velocity of second from first
+};
+
+// the candidates are given to the narrowphase in batches of about this many
+const std::size_t batch_size_c = 1024;
+// a box covering more grid cells than this is swept instead of put in the grid
+const std::int64_t max_cells_per_box_c = 64;
+
+// The box covered by a track over the time window, widened by half the range
+struct Swept_box {
+    double x_min, y_min, x_max, y_max;
+};
+
+static vector<Candidates> broadphase(const vector<const Track_base*>& tracks,
+                                      double range, double time);
+static void narrowphase(const Candidates& candidates, double range, double time,
+                        vector<Close_approach>& result);
+static void compute_CPAs(const double* rx, const double* ry, const double* rvx, const double* rvy,
+                         int n, double* cpa_time, double* cpa_range_sq);
+
+// Return every pair of tracks whose CPA is within range and time, ordered by index
+vector<Close_approach> screen_close_approaches(const vector<const Track_base*>& tracks,
+                                               double range, double time)
+{
+    vector<Close_approach> result;
+    if (tracks.size() < 2 || range < 0. || time < 0.)
+        return result;
+    for (const auto& candidates : broadphase(tracks, range, time))
+        narrowphase(candidates, range, time, result);
+    std::sort(result.begin(), result.end(), [](const Close_approach& a, const Close_approach& b)
+              { return a.first < b.first || (a.first == b.first && a.second < b.second); });
+    return result;
+}
+
+/* Put each swept box into every grid cell it overlaps and pair up the tracks that
+share a cell and whose boxes overlap. A pair that shares several cells is only
+taken in the cell holding the lower-left corner of the overlap. The cells are sized
+for a typical box, so a track much faster than the rest, whose box would cover many
+cells, is kept out of the grid and paired by a sweep instead.
+The candidates come back in batches of about a thousand so that the arrays stay small. */
+static vector<Candidates> broadphase(const vector<const Track_base*>& tracks,
+                                      double range, double time)
+{
+    int n = int(tracks.size());
+    vector<Swept_box> boxes(n);
+    double total_extent = 0.;
+    for (int i = 0; i < n; ++i) {
+        Point start = tracks[i]->get_position();
+        Point end = start + tracks[i]->get_velocity() * time;
+        Swept_box& box = boxes[i];
+        box.x_min = min(start.x, end.x) - range / 2.;
+        box.y_min = min(start.y, end.y) - range / 2.;
+        box.x_max = max(start.x, end.x) + range / 2.;
+        box.y_max = max(start.y, end.y) + range / 2.;
+        total_extent += max(box.x_max - box.x_min, box.y_max - box.y_min);
+    }
+    // cells about the size of a typical box keep both the cells per box and the
+    // boxes per cell small
+    double cell_size = max(range, total_extent / n);
+    if (!(cell_size > 0.))
+        cell_size = 1.;
+    const double limit = 1 << 30;
+    auto to_cell = [cell_size, limit](double coordinate) {
+        return std::int64_t(max(-limit, min(limit, std::floor(coordinate / cell_size))));
+    };
+    auto make_key = [](std::int64_t ix, std::int64_t iy) {
+        return (ix << 32) | std::uint32_t(iy);
+    };
+    auto overlap = [&boxes](int i, int j) {
+        const Swept_box& box_i = boxes[i];
+        const Swept_box& box_j = boxes[j];
+        return !(box_i.x_max < box_j.x_min || box_j.x_max < box_i.x_min ||
+                 box_i.y_max < box_j.y_min || box_j.y_max < box_i.y_min);
+    };
+
+    vector<Candidates> batches;
+    Candidates candidates;
+    auto add_candidate = [&](int i, int j) {
+        Cartesian_vector position = tracks[j]->get_position() - tracks[i]->get_position();
+        Cartesian_vector motion = tracks[j]->get_velocity() - tracks[i]->get_velocity();
+        candidates.first.push_back(i);
+        candidates.second.push_back(j);
+        candidates.rx.push_back(position.delta_x);
+        candidates.ry.push_back(position.delta_y);
+        candidates.rvx.push_back(motion.delta_x);
+        candidates.rvy.push_back(motion.delta_y);
+    };
+    auto end_batch = [&](std::size_t size) {
+        if (candidates.first.size() >= size) {
+            batches.push_back(std::move(candidates));
+            candidates = Candidates();
+        }
+    };
+
+    // a box that would cover too many cells is left out of the grid, and swept instead
+    unordered_map<std::int64_t, vector<int>> cells;
+    vector<bool> oversized(n, false);
+    vector<int> oversized_tracks;
+    for (int i = 0; i < n; ++i) {
+        const Swept_box& box = boxes[i];
+        auto x_cells = to_cell(box.x_max) - to_cell(box.x_min) + 1;
+        auto y_cells = to_cell(box.y_max) - to_cell(box.y_min) + 1;
+        if (x_cells * y_cells > max_cells_per_box_c) {
+            oversized[i] = true;
+            oversized_tracks.push_back(i);
+            continue;
+        }
+        for (auto ix = to_cell(box.x_min); ix <= to_cell(box.x_max); ++ix)
+            for (auto iy = to_cell(box.y_min); iy <= to_cell(box.y_max); ++iy)
+                cells[make_key(ix, iy)].push_back(i);
+    }
+
+    for (const auto& cell : cells) {
+        const vector<int>& members = cell.second;
+        for (std::size_t a = 0; a < members.size(); ++a) {
+            for (std::size_t b = a + 1; b < members.size(); ++b) {
+                int i = min(members[a], members[b]);
+                int j = max(members[a], members[b]);
+                if (!overlap(i, j))
+                    continue;
+                if (make_key(to_cell(max(boxes[i].x_min, boxes[j].x_min)),
+                             to_cell(max(boxes[i].y_min, boxes[j].y_min))) != cell.first)
+                    continue;
+                add_candidate(i, j);
+            }
+        }
+        end_batch(batch_size_c);
+    }
+
+    /* Each oversized box is paired with the boxes it overlaps by sweeping along x
+    through all the boxes in order of their left edge. A pair of oversized boxes is
+    taken from the one with the lower index. */
+    if (!oversized_tracks.empty()) {
+        vector<int> by_left_edge(n);
+        for (int i = 0; i < n; ++i)
+            by_left_edge[i] = i;
+        std::sort(by_left_edge.begin(), by_left_edge.end(),
+                  [&boxes](int i, int j) { return boxes[i].x_min < boxes[j].x_min; });
+        for (int i : oversized_tracks) {
+            for (int j : by_left_edge) {
+                if (boxes[j].x_min > boxes[i].x_max)
+                    break;
+                if (j == i || (oversized[j] && j < i) || !overlap(i, j))
+                    continue;
+                add_candidate(min(i, j), max(i, j));
+            }
+            end_batch(batch_size_c);
+        }
+    }
+    end_batch(1);
+    return batches;
+}
+
+// Compute the CPA of a batch of candidates and keep the ones inside the limits
+static void narrowphase(const Candidates& candidates, double range, double time,
+                        vector<Close_approach>& result)
+{
+    int n = int(candidates.first.size());
+    vector<double> cpa_time(n), cpa_range_sq(n);
+    compute_CPAs(candidates.rx.data(), candidates.ry.data(),
+                 candidates.rvx.data(), candidates.rvy.data(),
+                 n, cpa_time.data(), cpa_range_sq.data());
+    double range_sq = range * range;
+    for (int k = 0; k < n; ++k) {
+        if (cpa_time[k] <= time && cpa_range_sq[k] <= range_sq) {
+            bool moving = candidates.rvx[k] != 0. || candidates.rvy[k] != 0.;
+            result.push_back(Close_approach{candidates.first[k], candidates.second[k],
+                                            std::sqrt(cpa_range_sq[k]), cpa_time[k], moving});
+        }
+    }
+}
+
+/* For each relative position r and relative motion v, the CPA is at
+t = -(r . v) / (v . v), or now if that is in the past or the two are not moving
+relative to each other. Times past the window are left as they are so that the
+caller can reject them; the range is only meaningful for times inside the window.
+*/
+static void compute_CPAs(const double* rx, const double* ry, const double* rvx, const double* rvy,
+                         int n, double* cpa_time, double* cpa_range_sq)
+{
+    int k = 0;
+#if defined(__AVX__)
+    const __m256d zero4 = _mm256_setzero_pd();
+    for (; k + 4 <= n; k += 4) {
+        __m256d px = _mm256_loadu_pd(rx + k), py = _mm256_loadu_pd(ry + k);
+        __m256d vx = _mm256_loadu_pd(rvx + k), vy = _mm256_loadu_pd(rvy + k);
+        __m256d vv = _mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy));
+        __m256d pv = _mm256_add_pd(_mm256_mul_pd(px, vx), _mm256_mul_pd(py, vy));
+        __m256d moving = _mm256_cmp_pd(vv, zero4, _CMP_GT_OQ);
+        __m256d t = _mm256_and_pd(moving, _mm256_div_pd(_mm256_sub_pd(zero4, pv), vv));
+        t = _mm256_max_pd(t, zero4);
+        __m256d dx = _mm256_add_pd(px, _mm256_mul_pd(vx, t));
+        __m256d dy = _mm256_add_pd(py, _mm256_mul_pd(vy, t));
+        _mm256_storeu_pd(cpa_time + k, t);
+        _mm256_storeu_pd(cpa_range_sq + k, _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+    }
+#elif defined(__SSE2__)
+    const __m128d zero2 = _mm_setzero_pd();
+    for (; k + 2 <= n; k += 2) {
+        __m128d px = _mm_loadu_pd(rx + k), py = _mm_loadu_pd(ry + k);
+        __m128d vx = _mm_loadu_pd(rvx + k), vy = _mm_loadu_pd(rvy + k);
+        __m128d vv = _mm_add_pd(_mm_mul_pd(vx, vx), _mm_mul_pd(vy, vy));
+        __m128d pv = _mm_add_pd(_mm_mul_pd(px, vx), _mm_mul_pd(py, vy));
+        __m128d moving = _mm_cmpgt_pd(vv, zero2);
+        __m128d t = _mm_and_pd(moving, _mm_div_pd(_mm_sub_pd(zero2, pv), vv));
+        t = _mm_max_pd(t, zero2);
+        __m128d dx = _mm_add_pd(px, _mm_mul_pd(vx, t));
+        __m128d dy = _mm_add_pd(py, _mm_mul_pd(vy, t));
+        _mm_storeu_pd(cpa_time + k, t);
+        _mm_storeu_pd(cpa_range_sq + k, _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+    }
+#endif
+    for (; k < n; ++k) {
+        double vv = rvx[k] * rvx[k] + rvy[k] * rvy[k];
+        double pv = rx[k] * rvx[k] + ry[k] * rvy[k];
+        double t = vv > 0. ? (0. - pv) / vv : 0.;
+        t = max(t, 0.);
+        double dx = rx[k] + rvx[k] * t;
+        double dy = ry[k] + rvy[k] * t;
+        cpa_time[k] = t;
+        cpa_range_sq[k] = dx * dx + dy * dy;
+    }
+}
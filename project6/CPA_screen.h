@@ -0,0 +1,33 @@
+#ifndef CPA_SCREEN_H
+#define CPA_SCREEN_H
+
+#include <vector>
+
+/*
+CPA screening finds, in a whole set of tracks, every pair whose closest point of
+approach (CPA) is no farther apart than a given range and happens no later than
+a given time from now. It uses the same plane-sailing model as compute_CPA:
+each track keeps its current course and speed.
+
+The work is done in two phases. A broadphase puts the box swept by each track
+over the time window into a uniform grid, so only tracks whose boxes overlap
+are paired up; the few boxes too large for the grid are paired by sort and sweep. A narrowphase then computes the CPA of all the candidate pairs
+at once, over arrays, with AVX or SSE2 when the build targets them.
+*/
+
+class Track_base;
+
+// A pair of tracks, given by their index in the screened vector, that will pass close
+struct Close_approach {
+    int first;          // first < second
+    int second;
+    double range;       // range between the two at the CPA
+    double time;        // time from now until the CPA
+    bool moving;        // false if the two keep the same range, as when both are stopped
+};
+
+// Return every pair of tracks whose CPA is within range and time, ordered by index
+std::vector<Close_approach> screen_close_approaches(
+    const std::vector<const Track_base*>& tracks, double range, double time);
+
+#endif
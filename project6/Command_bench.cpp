@@ -0,0 +1,140 @@
+/*
+Benchmark for reading and dispatching commands.
+
+A script of one million commands is built in memory from a mix of ship commands,
+Model commands and commands that fail, several to a line, and replayed through a
+Controller over the standard scenario. There is no "go" in the script, so the time
+is that of the Controller and the command functions, not of updating the Model.
+The output is thrown away. Splitting the same script into words with a
+Command_reader alone is timed as well.
+
+Usage: command_bench [output_file [commands]]
+The results are printed and written to output_file (command_bench.json by default)
+as JSON, in the same form as those of geometry_bench.
+*/
+
+#include "Controller.h"
+#include "Command_reader.h"
+
+#include <chrono>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+using std::string;
+using std::vector;
+using std::cout;
+using std::endl;
+
+// a stream buffer that discards everything written to it
+class Null_buffer : public std::streambuf {
+protected:
+	int overflow(int c) override
+		{return c;}
+	std::streamsize xsputn(const char*, std::streamsize n) override
+		{return n;}
+};
+
+// the commands are taken in turn, commands_per_line_c to a line
+const vector<string> commands_c = {
+	"Ajax course 90 10",
+	"Xerxes position 30.5 -12.25 15",
+	"Valdez destination Exxon 10",
+	"Ajax stop",
+	"Xerxes destination Treasure_Island 20",
+	"cpa_alert off",
+	"combat_mode batched",
+	"Xerxes stop",
+	"cruise_itinerary greedy",
+	"Ajax position 1e1 2.5e1 12",
+	"combat_mode immediate",
+	"Valdez stop"
+};
+
+// A failing command discards the rest of its line, so one of these ends every line.
+const vector<string> failing_commands_c = {
+	"Valdez course 400 10",		// invalid heading
+	"no_such_command 1 2",		// unrecognized
+	"Ajax attack Nobody"		// no such ship
+};
+
+const int commands_per_line_c = 4;
+
+// return a script of n commands
+string make_script(long n)
+{
+	string script;
+	long good = 0, failing = 0;
+	for (long i = 0; i < n; ++i) {
+		if ((i + 1) % commands_per_line_c == 0 || i + 1 == n) {
+			script += failing_commands_c[failing++ % failing_commands_c.size()];
+			script += '\n';
+		} else {
+			script += commands_c[good++ % commands_c.size()];
+			script += ' ';
+		}
+	}
+	return script + "quit\n";
+}
+
+int main(int argc, char* argv[])
+{
+	string output_file = argc > 1 ? argv[1] : "command_bench.json";
+	long commands = argc > 2 ? std::atol(argv[2]) : 1000000;
+	if (commands <= 0) {
+		std::cerr << "Number of commands must be positive" << endl;
+		return 1;
+	}
+
+	string script = make_script(commands);
+
+	Null_buffer null_buffer;
+	std::streambuf* cout_buffer = cout.rdbuf(&null_buffer);
+	cout.setf(std::ios::fixed, std::ios::floatfield);
+	cout.precision(2);
+
+	std::istringstream controller_input(script);
+	Controller controller(controller_input);
+	auto start = std::chrono::steady_clock::now();
+	controller.run();
+	auto stop = std::chrono::steady_clock::now();
+	double controller_ns = std::chrono::duration<double, std::nano>(stop - start).count();
+
+	std::istringstream reader_input(script);
+	Command_reader reader(reader_input);
+	long words = 0;
+	start = std::chrono::steady_clock::now();
+	while (!reader.read_word().empty())
+		++words;
+	stop = std::chrono::steady_clock::now();
+	double reader_ns = std::chrono::duration<double, std::nano>(stop - start).count();
+
+	cout.rdbuf(cout_buffer);
+	cout << std::fixed << std::setprecision(2);
+	cout << std::left << std::setw(34) << "benchmark" << std::right << std::setw(12) << "operations"
+		 << std::setw(12) << "ns/op" << std::setw(12) << "Mops/s" << endl;
+	cout << std::left << std::setw(34) << "Controller::run per command" << std::right
+		 << std::setw(12) << commands << std::setw(12) << controller_ns / commands
+		 << std::setw(12) << 1e3 * commands / controller_ns << endl;
+	cout << std::left << std::setw(34) << "Command_reader::read_word" << std::right
+		 << std::setw(12) << words << std::setw(12) << reader_ns / words
+		 << std::setw(12) << 1e3 * words / reader_ns << endl;
+
+	std::ofstream os(output_file);
+	if (!os) {
+		std::cerr << "Cannot open " << output_file << endl;
+		return 1;
+	}
+	os << std::setprecision(6) << "{\n  \"benchmarks\": [\n"
+	   << "    {\"name\": \"Controller::run per command\", \"operations\": " << commands
+	   << ", \"ns_per_op\": " << controller_ns / commands << "},\n"
+	   << "    {\"name\": \"Command_reader::read_word\", \"operations\": " << words
+	   << ", \"ns_per_op\": " << reader_ns / words << "}\n"
+	   << "  ]\n}\n";
+	return 0;
+}
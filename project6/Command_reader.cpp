@@ -0,0 +1,114 @@
+#include "Command_reader.h"
+
+#include <istream>
+#include <charconv>
+#include <cctype>
+
+using std::string_view;
+
+static bool is_space(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+static bool is_digit(char c) {
+    return std::isdigit(static_cast<unsigned char>(c)) != 0;
+}
+
+// return the next word, reading more lines as needed, or an empty view at end of input
+string_view Command_reader::read_word() {
+    if (!skip_space())
+        return string_view();
+    std::size_t start = position;
+    while (position < line.size() && !is_space(line[position]))
+        ++position;
+    return line.substr(start, position - start);
+}
+
+// return the next word on the current line without reading it, or an empty view if there is none
+string_view Command_reader::peek_word_on_line() {
+    while (position < line.size() && is_space(line[position]))
+        ++position;
+    std::size_t end = position;
+    while (end < line.size() && !is_space(line[end]))
+        ++end;
+    return line.substr(position, end - position);
+}
+
+// read and return the rest of the current line, without the space in front
+string_view Command_reader::read_rest_of_line() {
+    while (position < line.size() && is_space(line[position]))
+        ++position;
+    string_view rest = line.substr(position);
+    position = line.size();
+    return rest;
+}
+
+bool Command_reader::read_int(int& value) {
+    if (!skip_space() || !starts_number())
+        return false;
+    const char* first = line.data() + position;
+    const char* last = line.data() + line.size();
+    // >> takes a leading plus sign, from_chars does not
+    if (*first == '+')
+        ++first;
+    auto result = std::from_chars(first, last, value);
+    if (result.ec != std::errc())
+        return false;
+    position = result.ptr - line.data();
+    return true;
+}
+
+bool Command_reader::read_double(double& value) {
+    if (!skip_space() || !starts_number())
+        return false;
+    const char* first = line.data() + position;
+    const char* last = line.data() + line.size();
+    if (*first == '+')
+        ++first;
+    auto result = std::from_chars(first, last, value);
+    if (result.ec != std::errc())
+        return false;
+    position = result.ptr - line.data();
+    return true;
+}
+
+// move to the start of the next word; return false at end of input
+bool Command_reader::skip_space() {
+    while (true) {
+        while (position < line.size() && is_space(line[position]))
+            ++position;
+        if (position < line.size())
+            return true;
+        if (!read_line())
+            return false;
+    }
+}
+
+// move to the start of the next line; return false at end of input
+bool Command_reader::read_line() {
+    if (is) {
+        if (!std::getline(*is, buffer))
+            return false;
+        line = buffer;
+    } else {
+        if (text.empty())
+            return false;
+        std::size_t end = text.find('\n');
+        line = text.substr(0, end);
+        text.remove_prefix(end == string_view::npos ? text.size() : end + 1);
+    }
+    position = 0;
+    ++line_number;
+    return true;
+}
+
+/* from_chars also reads "inf" and "nan", and takes a minus sign after a plus sign,
+ which >> does not; so a number must start with a digit or a point after at most one sign */
+bool Command_reader::starts_number() const {
+    std::size_t i = position;
+    if (line[i] == '+' || line[i] == '-')
+        ++i;
+    if (i < line.size() && line[i] == '.')
+        ++i;
+    return i < line.size() && is_digit(line[i]);
+}
@@ -0,0 +1,66 @@
+#ifndef COMMAND_READER_H
+#define COMMAND_READER_H
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+/* Command_reader splits the command input into words, a line at a time.
+ The input is either a stream or text in memory, such as a mapped file. Each line
+ of a stream is read into a buffer that is reused; text in memory is split where
+ it is. The words are returned as views into the line, so reading a command copies
+ and allocates nothing. A view is only good until the next line is read; a word
+ that must outlive the reading of further words has to be copied into a string first.
+
+ Words are separated by whitespace, and a command may go on to the following lines,
+ as with >> on the stream. Numbers are read from the start of a word the way >> reads
+ them: if the word does not start with a number nothing is read, and if only its start
+ is a number the rest is left to be read as the next word.
+ */
+
+class Command_reader {
+public:
+    // read from a stream
+    explicit Command_reader(std::istream& is_) : is(&is_) {}
+    // read from text in memory, which must outlive the reader
+    explicit Command_reader(std::string_view text_) : text(text_) {}
+
+    // return the next word, reading more lines as needed, or an empty view at end of input
+    std::string_view read_word();
+    // return the next word on the current line without reading it, or an empty view if
+    // the line has no more; this is how a command looks for an argument that may be left out
+    std::string_view peek_word_on_line();
+
+    // read an int or a double from the start of the next word; return false if there is none
+    bool read_int(int& value);
+    bool read_double(double& value);
+
+    // read and return the rest of the current line, without the space in front
+    std::string_view read_rest_of_line();
+
+    // discard the rest of the current line
+    void skip_line() { position = line.size(); }
+
+    // is the input a stream, which may have to wait for more to be typed?
+    bool is_from_stream() const { return is != nullptr; }
+
+    // the number of the current line, counting from 1
+    int get_line_number() const { return line_number; }
+
+private:
+    std::istream* is = nullptr;
+    std::string_view text;      // the text not yet read, when reading from memory
+    std::string buffer;         // the current line, when reading from a stream
+    std::string_view line;
+    std::size_t position = 0;
+    int line_number = 0;
+
+    // move to the start of the next line; return false at end of input
+    bool read_line();
+    // move to the start of the next word; return false at end of input
+    bool skip_space();
+    // is the next word a number that >> would read, possibly after a sign?
+    bool starts_number() const;
+};
+
+#endif
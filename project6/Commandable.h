@@ -1,15 +1,18 @@
 #ifndef COMMANDABLE_H
 #define COMMANDABLE_H
 
+#include "Geometry_fwd.h"
 #include <memory>
+#include <string>
+#include <vector>
 
 /* This is an abstract interface class supposed to be inherited by
  group and ship. Those classes inherit from this class can be controlled as
  one unit */
 
 class Island;
-struct Point;
 class Ship;
+struct Order;
 
 class Commandable {
 public:
@@ -46,6 +49,18 @@ public:
     
     // let the unit stop attacking target
     virtual void stop_attack() = 0;
+    
+    // set the side the unit fights on
+    virtual void set_side(const std::string& side) = 0;
+    
+    // let the unit attack hostile ships within radius on its own; a radius of 0 ends it
+    virtual void patrol(double radius) = 0;
+    
+    // add orders for the unit to carry out in turn, once it is done with what it is doing
+    virtual void queue_orders(const std::vector<Order>& orders) = 0;
+    
+    // discard the orders the unit has not yet carried out
+    virtual void clear_orders() = 0;
 };
 
 #endif
\ No newline at end of file
@@ -10,16 +10,30 @@
 #include "Bridge_view.h"
 #include "GPS_view.h"
 #include "Sailing_view.h"
+#include "Fleet_view.h"
 #include "Group.h"
+#include "Mapped_file.h"
+#include "Scenario.h"
+#include "Order_queue.h"
+#include "Output.h"
+#include "Log.h"
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <map>
 #include <memory>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cmath>
 
 using std::string;
-using std::cout;
 using std::cin;
 using std::endl;
 using std::map;
@@ -28,92 +42,270 @@ using std::shared_ptr;
 using std::make_shared;
 using namespace std::placeholders;
 
+namespace {
+
+/* A command table is a list of command names and the functions that run them,
+ sorted by name so that a command is found by binary search without building
+ anything at run time. */
+template <typename Handler>
+struct Command {
+    std::string_view name;
+    Handler handler;
+};
+
+template <typename Handler, std::size_t n>
+constexpr bool is_sorted_by_name(const Command<Handler> (&table)[n]) {
+    for (std::size_t i = 1; i < n; ++i)
+        if (!(table[i - 1].name < table[i].name))
+            return false;
+    return true;
+}
+
+// Given a cmd word, return the corresponding function ptr
+template <typename Handler, std::size_t n>
+Handler find_command(const Command<Handler> (&table)[n], std::string_view cmd_word) {
+    auto iter = std::lower_bound(std::begin(table), std::end(table), cmd_word,
+                                 [](const Command<Handler>& command, std::string_view word) {
+                                     return command.name < word;
+                                 });
+    if (iter == std::end(table) || iter->name != cmd_word)
+        throw Error("Unrecognized command!");
+    return iter->handler;
+}
+
+/* Read count numbers separated by commas from text, such as "10,-2.5", into values,
+ the same way as the numbers of any command; return false if text is not that. */
+bool read_numbers(std::string_view text, double values[], int count) {
+    string numbers(text);
+    std::replace(numbers.begin(), numbers.end(), ',', ' ');
+    Command_reader numbers_reader(numbers);
+    for (int i = 0; i < count; ++i)
+        if (!numbers_reader.read_double(values[i]))
+            return false;
+    return numbers_reader.read_word().empty();
+}
+
+// is the word an island or a position x,y?
+bool is_waypoint(std::string_view word) {
+    double numbers[2];
+    return !word.empty() &&
+           (Model::get_instance().is_island_present(string(word)) || read_numbers(word, numbers, 2));
+}
+
+// count points in rows filling the rectangle with corners p0 and p1, as near square as may be
+std::vector<Point> grid_positions(int count, Point p0, Point p1) {
+    int columns = int(std::ceil(std::sqrt(double(count))));
+    int rows = (count + columns - 1) / columns;
+    double dx = columns > 1 ? (p1.x - p0.x) / (columns - 1) : 0.;
+    double dy = rows > 1 ? (p1.y - p0.y) / (rows - 1) : 0.;
+    std::vector<Point> positions;
+    positions.reserve(count);
+    for (int i = 0; i < count; ++i)
+        positions.emplace_back(p0.x + dx * (i % columns), p0.y + dy * (i / columns));
+    return positions;
+}
+
+// count points evenly spaced from p0 to p1
+std::vector<Point> line_positions(int count, Point p0, Point p1) {
+    std::vector<Point> positions;
+    positions.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        double t = count > 1 ? double(i) / (count - 1) : 0.;
+        positions.emplace_back(p0.x + (p1.x - p0.x) * t, p0.y + (p1.y - p0.y) * t);
+    }
+    return positions;
+}
+
+// count points at random in the rectangle with corners p0 and p1, the same ones every time
+std::vector<Point> random_positions(int count, Point p0, Point p1) {
+    std::mt19937 generator;
+    std::uniform_real_distribution<double> unit(0., 1.);
+    std::vector<Point> positions;
+    positions.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        double x = p0.x + (p1.x - p0.x) * unit(generator);
+        positions.emplace_back(x, p0.y + (p1.y - p0.y) * unit(generator));
+    }
+    return positions;
+}
+
+// the ship states as status names them
+const std::pair<std::string_view, Ship_state> state_words_c[] = {
+    {"moving_to_position", Ship_state::moving_to_position},
+    {"moving_to_island", Ship_state::moving_to_island},
+    {"moving_on_course", Ship_state::moving_on_course},
+    {"stopped", Ship_state::stopped},
+    {"docked", Ship_state::docked},
+    {"dead_in_the_water", Ship_state::dead_in_the_water},
+    {"sunk", Ship_state::sunk}
+};
+
+} // namespace
+
+// how many scripts may be running at once, each sourced from the one before
+const int max_source_depth_c = 16;
+
+Controller::Controller() : input_reader(cin) {}
+
+Controller::Controller(std::istream& input) : input_reader(input) {}
+
 // create View object, run the program by acccepting user commands, then destroy View object
 void Controller::run() {
-    map<string, void (Controller::*)(shared_ptr<Commandable>)> control_cmds {
+    Model::get_instance().set_command_runner([this](const string& commands) {
+        run_scheduled_commands(commands);
+    });
+    long executed = 0, errors = 0;
+    try {
+        run_commands(executed, errors);
+    } catch (exception& e) {
+        out << e.what() << endl;
+    }
+    Model::get_instance().set_command_runner(nullptr);
+    quit_cmd();
+}
+
+/* Run commands from the current reader until quit or the end of its input. A command
+ that fails reports the error and discards the rest of its line, and the commands
+ go on. Count the commands that ran and those that failed. */
+void Controller::run_commands(long& executed, long& errors) {
+    while (true) {
+        out << "\nTime " << Model::get_instance().get_time();
+        out << ": Enter command: ";
+        // what the last command printed goes out before waiting for the next one
+        if (reader->is_from_stream())
+            out.flush();
+        try {
+            if (!run_command())
+                return;
+            ++executed;
+        } catch (Error& error) {
+            out << error.what() << endl;
+            reader->skip_line();
+            ++errors;
+        }
+    }
+}
+
+// Read and run one command; return false at quit or the end of the input.
+bool Controller::run_command() {
+    using Control_handler = void (Controller::*)(shared_ptr<Commandable>);
+    static constexpr Command<Control_handler> control_cmds[] {
+        {"attack", &Controller::attack_cmd},
         {"course", &Controller::course_cmd},
-        {"position", &Controller::position_cmd},
         {"destination", &Controller::destination_cmd},
-        {"load_at", &Controller::load_at_cmd},
-        {"unload_at", &Controller::unload_at_cmd},
         {"dock_at", &Controller::dock_at_cmd},
-        {"attack", &Controller::attack_cmd},
+        {"load_at", &Controller::load_at_cmd},
+        {"patrol", &Controller::patrol_cmd},
+        {"position", &Controller::position_cmd},
         {"refuel", &Controller::refuel_cmd},
+        {"route", &Controller::route_cmd},
+        {"side", &Controller::side_cmd},
         {"stop", &Controller::stop_cmd},
-        {"stop_attack", &Controller::stop_attack_cmd}
+        {"stop_attack", &Controller::stop_attack_cmd},
+        {"unload_at", &Controller::unload_at_cmd}
     };
+    static_assert(is_sorted_by_name(control_cmds), "control commands must be sorted by name");
     
-    map<string, void (Controller::*)()> cmds {
-        {"default", &Controller::default_cmd},
-        {"size", &Controller::size_cmd},
-        {"zoom", &Controller::zoom_cmd},
-        {"pan", &Controller::pan_cmd},
-        {"show", &Controller::show_cmd},
-        {"status", &Controller::status_cmd},
-        {"go", &Controller::go_cmd},
+    using Handler = void (Controller::*)();
+    static constexpr Command<Handler> cmds[] {
+        {"add_member", &Controller::add_member_cmd},
+        {"at", &Controller::at_cmd},
+        {"close_bridge_view", &Controller::close_bridge_view},
+        {"close_fleet_view", &Controller::close_fleet_view},
+        {"close_gps_view", &Controller::close_gps_view},
+        {"close_log_file", &Controller::close_log_file},
+        {"close_map_view", &Controller::close_map_view_cmd},
+        {"close_sailing_view", &Controller::close_sailing_view},
+        {"combat_mode", &Controller::combat_mode_cmd},
+        {"cpa_alert", &Controller::cpa_alert_cmd},
+        {"cpa_report", &Controller::cpa_report_cmd},
         {"create", &Controller::create_cmd},
-        {"save", &Controller::save_cmd},
-        {"restore", &Controller::restore_cmd},
+        {"create_fleet", &Controller::create_fleet_cmd},
         {"create_group", &Controller::create_group_cmd},
+        {"cruise_itinerary", &Controller::cruise_itinerary_cmd},
+        {"default", &Controller::default_cmd},
         {"delete_group", &Controller::delete_group_cmd},
-        {"add_member", &Controller::add_member_cmd},
         {"delete_member", &Controller::delete_member_cmd},
-        {"open_map_view", &Controller::open_map_view_cmd},
-        {"close_map_view", &Controller::close_map_view_cmd},
-        {"open_sailing_view", &Controller::open_sailing_view},
-        {"close_sailing_view", &Controller::close_sailing_view},
-        {"open_bridge_view", &Controller::open_bridge_view},
-        {"close_bridge_view", &Controller::close_bridge_view},
-        {"open_gps_view", &Controller::open_gps_view},
-        {"close_gps_view", &Controller::close_gps_view},
+        {"every", &Controller::every_cmd},
+        {"go", &Controller::go_cmd},
         {"gps_default", &Controller::default_gps_cmd},
         {"gps_size", &Controller::size_gps_cmd},
-        {"gps_zoom", &Controller::zoom_gps_cmd}
+        {"gps_zoom", &Controller::zoom_gps_cmd},
+        {"log", &Controller::log_cmd},
+        {"open_bridge_view", &Controller::open_bridge_view},
+        {"open_fleet_view", &Controller::open_fleet_view},
+        {"open_gps_view", &Controller::open_gps_view},
+        {"open_log_file", &Controller::open_log_file},
+        {"open_map_view", &Controller::open_map_view_cmd},
+        {"open_sailing_view", &Controller::open_sailing_view},
+        {"pan", &Controller::pan_cmd},
+        {"restore", &Controller::restore_cmd},
+        {"save", &Controller::save_cmd},
+        {"scenario", &Controller::scenario_cmd},
+        {"show", &Controller::show_cmd},
+        {"size", &Controller::size_cmd},
+        {"source", &Controller::source_cmd},
+        {"status", &Controller::status_cmd},
+        {"zoom", &Controller::zoom_cmd}
     };
+    static_assert(is_sorted_by_name(cmds), "commands must be sorted by name");
     
+    std::string_view first_word = reader->read_word();
+    // the end of the input ends it as quit does
+    if (first_word.empty() || first_word == "quit")
+        return false;
+    if (auto commandable_ptr = find_addressee(first_word)) {
+        /* The whole line is recorded before any of it is carried out, so a line with an
+         error anywhere in it changes nothing. Then the first command is carried out, and
+         the commands chained to it with "then" are queued, to be carried out in turn. */
+        auto recorder_ptr = make_shared<Order_recorder>();
+        std::string_view cmd_word = reader->read_word();
+        (this->*find_command(control_cmds, cmd_word))(recorder_ptr);
+        bool discards_orders = recorder_ptr->discards_orders();
+        while (reader->peek_word_on_line() == "then") {
+            reader->read_word();
+            cmd_word = reader->read_word();
+            (this->*find_command(control_cmds, cmd_word))(recorder_ptr);
+        }
+        const std::vector<Order>& orders = recorder_ptr->get_orders();
+        if (discards_orders)
+            commandable_ptr->clear_orders();
+        orders.front().carry_out(*commandable_ptr);
+        commandable_ptr->queue_orders(std::vector<Order>(orders.begin() + 1, orders.end()));
+    } else {
+        (this->*find_command(cmds, first_word))();
+    }
+    return true;
+}
+
+/* Run a line of scheduled commands at the start of an update, the same way as commands
+ that are typed in, but without prompts. They may not update or replace the Model. */
+void Controller::run_scheduled_commands(const string& commands) {
+    out << "Scheduled: " << commands << endl;
+    Command_reader scheduled_reader(commands);
+    Command_reader* outer_reader = reader;
+    reader = &scheduled_reader;
+    running_scheduled = true;
     while (true) {
-        cout << "\nTime " << Model::get_instance().get_time();
-        cout << ": Enter command: ";
         try {
-            string first_word;
-            cin >> first_word;
-            
-            if (first_word == "quit") {
-                quit_cmd();
-                return;
-            }
-            if (Model::get_instance().is_ship_present(first_word) ||
-                Model::get_instance().is_group_present(first_word)) {
-                string cmd_word;
-                cin >> cmd_word;
-                auto commandable_ptr = get_commandable_object(first_word);
-                (this->*get_func_ptr(control_cmds, cmd_word))(commandable_ptr);
-            } else {
-                (this->*get_func_ptr(cmds, first_word))();
-            }
+            if (!run_command())
+                break;
         } catch (Error& error) {
-            cout << error.what() << endl;
-            cin.clear();
-            while (cin.get() != '\n');
-        } catch (exception& e) {
-            cout << e.what() << endl;
-            quit_cmd();
-            return;
+            out << error.what() << endl;
+            reader->skip_line();
+        } catch (...) {
+            reader = outer_reader;
+            running_scheduled = false;
+            throw;
         }
     }
-}
-
-// Given a cmd string, return the corresponding function ptr
-template<typename T>
-T Controller::get_func_ptr(map<string, T> cmds, const string& cmd_word) {
-    auto iter = cmds.find(cmd_word);
-    if (iter == cmds.end())
-        throw Error("Unrecognized command!");
-    return iter->second;
+    reader = outer_reader;
+    running_scheduled = false;
 }
 
 void Controller::quit_cmd() {
-    cout << "Done" << endl;
+    out << "Done" << endl;
+    out.flush();
 }
 
 /* View Commands */
@@ -125,9 +317,7 @@ void Controller::default_cmd() {
 
 void Controller::size_cmd() {
     check_map_is_open();
-    int new_size;
-    if(!(cin >> new_size))
-        throw Error("Expected an integer!");
+    int new_size = read_int();
     map_view->set_size(new_size);
 }
 
@@ -182,7 +372,10 @@ void Controller::close_sailing_view() {
 }
 
 void Controller::open_bridge_view() {
-    string ship_name = read_string(cin);
+    open_bridge_view(string(read_word()));
+}
+
+void Controller::open_bridge_view(const string& ship_name) {
     auto ship_ptr = Model::get_instance().get_ship_ptr(ship_name);
     if (bridge_views.find(ship_name) != bridge_views.end())
         throw Error("Bridge view is already open for that ship!");
@@ -192,7 +385,7 @@ void Controller::open_bridge_view() {
 }
 
 void Controller::close_bridge_view() {
-    string ship_name = read_string(cin);
+    string ship_name(read_word());
     auto iter = bridge_views.find(ship_name);
     if (iter == bridge_views.end())
         throw Error("Bridge view for that ship is not open!");
@@ -201,8 +394,10 @@ void Controller::close_bridge_view() {
 }
 
 void Controller::open_gps_view() {
-    string ship_name;
-    cin >> ship_name;
+    open_gps_view(string(read_word()));
+}
+
+void Controller::open_gps_view(const string& ship_name) {
     auto ship_ptr = Model::get_instance().get_ship_ptr(ship_name);
     if (gps_views.find(ship_name) != gps_views.end())
         throw Error("GPS view is already open for that ship!");
@@ -212,8 +407,7 @@ void Controller::open_gps_view() {
 }
 
 void Controller::close_gps_view() {
-    string ship_name;
-    cin >> ship_name;
+    string ship_name(read_word());
     auto iter = gps_views.find(ship_name);
     if (iter == gps_views.end())
         throw Error("GPS view for that ship is not open!");
@@ -227,9 +421,7 @@ void Controller::default_gps_cmd() {
 
 void Controller::size_gps_cmd() {
     shared_ptr<GPS_view> gps_view = get_open_gps_map();
-    int new_size;
-    if(!(cin >> new_size))
-        throw Error("Expected an integer!");
+    int new_size = read_int();
     gps_view->set_size(new_size);
 }
 
@@ -239,10 +431,37 @@ void Controller::zoom_gps_cmd() {
     gps_view->set_scale(scale);
 }
 
+void Controller::open_fleet_view() {
+    if (fleet_view != nullptr)
+        throw Error("Fleet view is already open!");
+    fleet_view = make_shared<Fleet_view>();
+    Model::get_instance().attach(fleet_view);
+}
+
+void Controller::close_fleet_view() {
+    if (fleet_view == nullptr)
+        throw Error("Fleet view is not open!");
+    Model::get_instance().detach(fleet_view);
+    fleet_view = nullptr;
+}
+
+// send the log to a file of binary records, instead of the output
+void Controller::open_log_file() {
+    string file_name(read_word());
+    if (Log::is_file_open())
+        throw Error("Log file is already open!");
+    Log::open_file(file_name);
+}
+
+void Controller::close_log_file() {
+    if (!Log::is_file_open())
+        throw Error("Log file is not open!");
+    Log::close_file();
+}
+
 // throw an error if map is not open
 shared_ptr<GPS_view> Controller::get_open_gps_map() {
-    string ship_name;
-    cin >> ship_name;
+    string ship_name(read_word());
     auto iter = gps_views.find(ship_name);
     if (iter == gps_views.end())
         throw Error("GPS view for that ship is not open!");
@@ -251,30 +470,206 @@ shared_ptr<GPS_view> Controller::get_open_gps_map() {
 
 /* Model Commands */
 
+/* status [type:<type>] [state:<state>] [near:x,y,radius] [fuel<amount] [limit n] [offset k]
+ Describe every object, or only those that pass the tests given, in name order. The
+ tests may come in any order; the first word that is not one of them is left for the
+ next command on the line. */
 void Controller::status_cmd() {
-    Model::get_instance().describe();
+    const std::string_view type_c = "type:", state_c = "state:", near_c = "near:", fuel_c = "fuel<";
+    Status_filter filter;
+    bool filtered = false;
+    for (std::string_view word = reader->peek_word_on_line(); !word.empty();
+         word = reader->peek_word_on_line()) {
+        if (word.substr(0, type_c.size()) == type_c) {
+            filter.type = string(word.substr(type_c.size()));
+        } else if (word.substr(0, state_c.size()) == state_c) {
+            auto state_iter = std::find_if(std::begin(state_words_c), std::end(state_words_c),
+                [word, &state_c](const auto& state_word)
+                    { return state_word.first == word.substr(state_c.size()); });
+            if (state_iter == std::end(state_words_c))
+                throw Error("Unrecognized ship state!");
+            filter.by_state = true;
+            filter.state = state_iter->second;
+        } else if (word.substr(0, near_c.size()) == near_c) {
+            double numbers[3];
+            if (!read_numbers(word.substr(near_c.size()), numbers, 3))
+                throw Error("Expected near:x,y,radius!");
+            if (numbers[2] <= 0.)
+                throw Error("Radius must be positive!");
+            filter.near = true;
+            filter.center = Point(numbers[0], numbers[1]);
+            filter.radius = numbers[2];
+        } else if (word.substr(0, fuel_c.size()) == fuel_c) {
+            if (!read_numbers(word.substr(fuel_c.size()), &filter.fuel_below, 1))
+                throw Error("Expected fuel<amount!");
+            filter.by_fuel = true;
+        } else if (word == "limit" || word == "offset") {
+            bool is_limit = word == "limit";
+            reader->read_word();
+            int number = read_int();
+            if (is_limit && number <= 0)
+                throw Error("Limit must be positive!");
+            if (number < 0)
+                throw Error("Offset must not be negative!");
+            (is_limit ? filter.limit : filter.offset) = number;
+            filtered = true;
+            continue;
+        } else {
+            break;
+        }
+        reader->read_word();
+        filtered = true;
+    }
+    if (!filtered)
+        Model::get_instance().describe();
+    else if (Model::get_instance().describe(filter) == 0)
+        out << "No objects match" << endl;
 }
 
 void Controller::go_cmd() {
+    if (running_scheduled)
+        throw Error("Cannot do that in a scheduled command!");
     Model::get_instance().update();
 }
 
+// at <time> <commands>: run the rest of the line at the start of the update to that time
+void Controller::at_cmd() {
+    int time = read_int();
+    if (time <= Model::get_instance().get_time())
+        throw Error("Time must be in the future!");
+    Model::get_instance().schedule_commands(time, 0, read_scheduled_commands());
+}
+
+// every <hours> <commands>: run the rest of the line every so many hours from now on
+void Controller::every_cmd() {
+    int period = read_int();
+    if (period <= 0)
+        throw Error("Period must be positive!");
+    if (period > std::numeric_limits<int>::max() - Model::get_instance().get_time())
+        throw Error("Time is too far in the future!");
+    Model::get_instance().schedule_commands(Model::get_instance().get_time() + period, period,
+                                            read_scheduled_commands());
+}
+
+// read the rest of the line as the commands to schedule
+string Controller::read_scheduled_commands() {
+    string commands(reader->read_rest_of_line());
+    if (commands.empty())
+        throw Error("Expected a command!");
+    return commands;
+}
+
+// report every pair of ships that will pass within a range inside a time
+void Controller::cpa_report_cmd() {
+    double range = read_double();
+    double time = read_double();
+    if (range < 0. || time < 0.)
+        throw Error("Range and time must not be negative!");
+    Model::get_instance().describe_close_approaches(range, time);
+}
+
+// report close approaches after every update, or stop reporting them with "off"
+void Controller::cpa_alert_cmd() {
+    string first_word(read_word());
+    if (first_word == "off") {
+        Model::get_instance().clear_cpa_alert();
+        return;
+    }
+    double range;
+    std::istringstream range_is(first_word);
+    if (!(range_is >> range))
+        throw Error("Expected a double!");
+    double time = read_double();
+    if (range < 0. || time < 0.)
+        throw Error("Range and time must not be negative!");
+    Model::get_instance().set_cpa_alert(range, time);
+}
+
+// plan cruise itineraries greedily, or greedily and then improved by 2-opt
+void Controller::cruise_itinerary_cmd() {
+    std::string_view planning = read_word();
+    if (planning == "greedy")
+        Model::get_instance().set_two_opt_itineraries(false);
+    else if (planning == "two_opt")
+        Model::get_instance().set_two_opt_itineraries(true);
+    else
+        throw Error("Expected greedy or two_opt!");
+}
+
+// land each hit when it is fired, or resolve all of an update's hits together at its end
+void Controller::combat_mode_cmd() {
+    std::string_view mode = read_word();
+    if (mode == "immediate")
+        Model::get_instance().set_batched_combat(false);
+    else if (mode == "batched")
+        Model::get_instance().set_batched_combat(true);
+    else
+        throw Error("Expected immediate or batched!");
+}
+
+/* log all | none | <category> ...
+ Log only the categories given, of movement, combat, fuel and cargo. */
+void Controller::log_cmd() {
+    std::string_view word = read_word();
+    unsigned categories = 0;
+    if (word == "all") {
+        categories = all_log_categories_c;
+    } else if (word != "none") {
+        categories = unsigned(Log::get_category(word));
+        // more categories may follow, and then another command on the same line
+        while (Log::is_category(reader->peek_word_on_line()))
+            categories |= unsigned(Log::get_category(reader->read_word()));
+    }
+    Log::set_categories(categories);
+}
+
 void Controller::create_cmd() {
-    string ship_name = read_string(cin);
+    string ship_name(read_word());
     if (ship_name.length() < 2)
         throw Error("Name is too short!");
     if (Model::get_instance().is_name_in_use(ship_name))
         throw Error("Name is invalid!");
-    string ship_type = read_string(cin);
+    string ship_type(read_word());
     Point init_position{read_double(), read_double()};
     Model::get_instance().add_ship(create_ship(ship_name, ship_type, init_position));
 }
 
+/* create_fleet <prefix> <type> <count> <x0> <y0> <x1> <y1> [grid|line|random]
+ The ships are named prefix followed by a number, and so are exempt from the rule on
+ their first two characters among themselves; the prefix must not break it with any
+ other name. They are placed in a grid filling the rectangle with corners (x0, y0)
+ and (x1, y1), evenly along the line between the two points, or at random in the
+ rectangle, the same way every time. */
+void Controller::create_fleet_cmd() {
+    string prefix(read_word());
+    if (prefix.length() < 2)
+        throw Error("Name is too short!");
+    if (Model::get_instance().is_name_in_use(prefix))
+        throw Error("Name is invalid!");
+    string ship_type(read_word());
+    int count = read_int();
+    if (count <= 0)
+        throw Error("Count must be positive!");
+    Point corner0{read_double(), read_double()};
+    Point corner1{read_double(), read_double()};
+    // the pattern may be left out, and another command follow on the same line
+    std::string_view pattern = reader->peek_word_on_line();
+    std::vector<Point> positions;
+    if (pattern == "line")
+        positions = line_positions(count, corner0, corner1);
+    else if (pattern == "random")
+        positions = random_positions(count, corner0, corner1);
+    else
+        positions = grid_positions(count, corner0, corner1);
+    if (pattern == "grid" || pattern == "line" || pattern == "random")
+        reader->read_word();
+    Model::get_instance().add_ships(create_fleet(prefix, ship_type, positions));
+}
+
 // open the file and return fstream
 template <typename T>
-T Controller::read_open_file(std::istream& is) {
-    string file_name;
-    is >> file_name;
+T Controller::read_open_file() {
+    string file_name(read_word());
     T fs;
     fs.open(file_name);
     if (!fs)
@@ -285,7 +680,7 @@ T Controller::read_open_file(std::istream& is) {
 }
 
 void Controller::save_cmd() {
-    std::ofstream os = read_open_file<std::ofstream>(cin);
+    std::ofstream os = read_open_file<std::ofstream>();
     os.precision(10);
     Model::get_instance().save(os);
     os.close();
@@ -293,10 +688,14 @@ void Controller::save_cmd() {
 
 
 void Controller::restore_cmd() {
+    if (running_scheduled)
+        throw Error("Cannot do that in a scheduled command!");
     reset();
     try {
-        std::ifstream is = read_open_file<std::ifstream>(cin);
-        int views_size = read_int(is);
+        std::ifstream is = read_open_file<std::ifstream>();
+        // the fleet view is rebuilt from the objects, so attach it once they are restored
+        bool restore_fleet_view = false;
+        int views_size = ::read_int(is);
         while (views_size --) {
             string view_type;
             is >> view_type;
@@ -314,11 +713,17 @@ void Controller::restore_cmd() {
                 shared_ptr<GPS_view> gps_view = make_shared<GPS_view>(GPS_view(is));
                 gps_views[gps_view->get_ship_name()] = gps_view;
                 Model::get_instance().attach(gps_view);
+            } else if (view_type == "Fleet_view") {
+                restore_fleet_view = true;
             } else {
                 throw Error("Unknow view type");
             }
         }
         Model::get_instance().restore(is);
+        if (restore_fleet_view) {
+            fleet_view = make_shared<Fleet_view>();
+            Model::get_instance().attach(fleet_view);
+        }
         is.close();
     } catch (...) {
         reset();
@@ -327,43 +732,138 @@ void Controller::restore_cmd() {
 }
 
 
+/* Run the commands in a file, which is mapped into memory and read in place, then
+ report how many ran and how fast. The commands are run as if they had been typed,
+ except that quit or the end of the file only ends the file. */
+void Controller::source_cmd() {
+    string file_name(read_word());
+    if (source_depth == max_source_depth_c)
+        throw Error("Scripts are nested too deeply!");
+    Mapped_file file(file_name);
+    Command_reader file_reader(file.get_text());
+    Command_reader* outer_reader = reader;
+    reader = &file_reader;
+    ++source_depth;
+    long executed = 0, errors = 0;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        run_commands(executed, errors);
+    } catch (...) {
+        reader = outer_reader;
+        --source_depth;
+        throw;
+    }
+    auto stop = std::chrono::steady_clock::now();
+    reader = outer_reader;
+    --source_depth;
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    out << file_name << ": " << executed << " commands run, " << errors << " failed, in "
+         << seconds << " s, " << (seconds > 0. ? executed / seconds : 0.) << " commands/sec" << endl;
+}
+
+
+/* Replace the world with the one declared in a scenario file, and open the views it
+ declares. The whole file is read before anything is changed, so a file with a mistake
+ in it leaves the world as it was. */
+void Controller::scenario_cmd() {
+    if (running_scheduled)
+        throw Error("Cannot do that in a scheduled command!");
+    string file_name(read_word());
+    auto start = std::chrono::steady_clock::now();
+    Scenario scenario;
+    {
+        Mapped_file file(file_name);
+        scenario = read_scenario(file.get_text());
+    }
+    reset();
+    Model::get_instance().load_scenario(scenario);
+    for (const auto& view : scenario.views) {
+        if (view.kind == "map")
+            open_map_view_cmd();
+        else if (view.kind == "sailing")
+            open_sailing_view();
+        else if (view.kind == "fleet")
+            open_fleet_view();
+        else if (view.kind == "bridge")
+            open_bridge_view(view.ship_name);
+        else
+            open_gps_view(view.ship_name);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    out << file_name << ": " << scenario.islands.size() << " islands, " << scenario.ships.size()
+         << " ships, " << scenario.groups.size() << " groups loaded in "
+         << std::chrono::duration<double>(stop - start).count() << " s" << endl;
+}
+
 /* Group Commands */
 void Controller::create_group_cmd() {
-    string group_name = read_string(cin);
+    string group_name(read_word());
     if (!Model::get_instance().is_group_name_valid(group_name))
         throw Error("Group name is invalid!");
     Model::get_instance().attach_group(make_shared<Group>(group_name));
-    cout << "Group " << group_name << " created" << endl;
+    out << "Group " << group_name << " created" << endl;
 }
 
 void Controller::delete_group_cmd() {
-    string group_name = read_string(cin);
+    string group_name(read_word());
     auto group_ptr = Model::get_instance().get_group_ptr(group_name);
     Model::get_instance().detach_group(group_ptr);
-    cout << "Group " << group_name << " deleted" << endl;
+    out << "Group " << group_name << " deleted" << endl;
 }
 
 void Controller::add_member_cmd() {
-    shared_ptr<Commandable> member = get_commandable_object(read_string(cin));
-    shared_ptr<Group> group_ptr = Model::get_instance().get_group_ptr(read_string(cin));
+    shared_ptr<Commandable> member = get_commandable_object(read_word());
+    shared_ptr<Group> group_ptr = Model::get_instance().get_group_ptr(string(read_word()));
     group_ptr->add_member(member);
 }
 
 void Controller::delete_member_cmd() {
-    shared_ptr<Commandable> member = get_commandable_object(read_string(cin));
-    shared_ptr<Group> group_ptr = Model::get_instance().get_group_ptr(read_string(cin));
+    shared_ptr<Commandable> member = get_commandable_object(read_word());
+    shared_ptr<Group> group_ptr = Model::get_instance().get_group_ptr(string(read_word()));
     group_ptr->delete_member(member);
 }
 
-/* Read a string from cin and get either a ship pointer or a group ptr.
+/* Get either a ship pointer or a group ptr by name.
  Throw an error otherwise. */
-shared_ptr<Commandable> Controller::get_commandable_object(string name) {
-    if (Model::get_instance().is_ship_present(name))
-        return Model::get_instance().get_ship_ptr(name);
-    else if (Model::get_instance().is_group_present(name))
-        return Model::get_instance().get_group_ptr(name);
-    else
+shared_ptr<Commandable> Controller::get_commandable_object(std::string_view name) {
+    auto commandable_ptr = Model::get_instance().find_commandable(name);
+    if (!commandable_ptr)
         throw Error("Commandable object not found!");
+    return commandable_ptr;
+}
+
+/* Return the ship or group a command is addressed to, or nullptr if the word is neither
+ a name nor a pattern. A pattern addresses every ship it matches, in name order, as a
+ group made up for the command:
+     Tk*                  the ships whose names begin with Tk (* alone is every ship)
+     type:Cruiser         the ships of a type
+     within:x,y,radius    the ships no farther than radius from (x, y)
+ Throw Error if a pattern matches no ship. */
+shared_ptr<Commandable> Controller::find_addressee(std::string_view word) {
+    Model& model = Model::get_instance();
+    if (auto commandable_ptr = model.find_commandable(word))
+        return commandable_ptr;
+    const std::string_view type_c = "type:", within_c = "within:";
+    std::vector<shared_ptr<Ship>> matched;
+    if (!word.empty() && word.back() == '*') {
+        matched = model.find_ships_by_prefix(word.substr(0, word.size() - 1));
+    } else if (word.substr(0, type_c.size()) == type_c) {
+        matched = model.find_ships_by_type(word.substr(type_c.size()));
+    } else if (word.substr(0, within_c.size()) == within_c) {
+        double numbers[3];
+        if (!read_numbers(word.substr(within_c.size()), numbers, 3))
+            throw Error("Expected within:x,y,radius!");
+        if (numbers[2] <= 0.)
+            throw Error("Radius must be positive!");
+        matched = model.find_ships_within(Point(numbers[0], numbers[1]), numbers[2]);
+    } else {
+        return nullptr;
+    }
+    if (matched.empty())
+        throw Error("No ships match!");
+    return make_shared<Group>(string(word),
+                              std::vector<shared_ptr<Commandable>>(matched.begin(), matched.end()),
+                              true);
 }
 
 /* Control Commands */
@@ -373,22 +873,25 @@ void Controller::course_cmd(shared_ptr<Commandable> commandable_ptr) {
     if (course < 0. || course >= 360.)
         throw Error("Invalid heading entered!");
     double speed = read_speed();
+    commandable_ptr->clear_orders();
     commandable_ptr->set_course_and_speed(course, speed);
 }
 
 void Controller::position_cmd(shared_ptr<Commandable> commandable_ptr) {
     Point destination{read_double(), read_double()};
     double speed = read_speed();
+    commandable_ptr->clear_orders();
     commandable_ptr->set_destination_position_and_speed(destination, speed);
 }
 
 void Controller::destination_cmd(shared_ptr<Commandable> commandable_ptr) {
     shared_ptr<Island> island_ptr = read_and_get_island();
     double speed = read_speed();
+    commandable_ptr->clear_orders();
     commandable_ptr->set_destination_island_and_speed(island_ptr, speed);
 }
 
-// Read in speed from cin. Throw Error if it's negative
+// Read in speed from the input. Throw Error if it's negative
 double Controller::read_speed() {
     double speed = read_double();
     if (speed < 0.)
@@ -396,37 +899,53 @@ double Controller::read_speed() {
     return speed;
 }
 
-// Read a double from cin. Throw Error if double is not read in.
+// Read a double from the input. Throw Error if double is not read in.
 double Controller::read_double() {
     double number;
-    if (!(cin >> number))
+    if (!reader->read_double(number))
         throw Error("Expected a double!");
     return number;
 }
 
+// Read an int from the input. Throw Error if int is not read in.
+int Controller::read_int() {
+    int number;
+    if (!reader->read_int(number))
+        throw Error("Expected an integer!");
+    return number;
+}
+
+// Read the next word from the input; it is only good until more words are read.
+std::string_view Controller::read_word() {
+    return reader->read_word();
+}
+
 void Controller::load_at_cmd(shared_ptr<Commandable> commandable_ptr) {
     shared_ptr<Island> island_ptr = read_and_get_island();
+    commandable_ptr->clear_orders();
     commandable_ptr->set_load_destination(island_ptr);
 }
 
 void Controller::unload_at_cmd(shared_ptr<Commandable> commandable_ptr) {
     shared_ptr<Island> island_ptr = read_and_get_island();
+    commandable_ptr->clear_orders();
     commandable_ptr->set_unload_destination(island_ptr);
 }
 
 void Controller::dock_at_cmd(shared_ptr<Commandable> commandable_ptr) {
     shared_ptr<Island> island_ptr = read_and_get_island();
+    commandable_ptr->clear_orders();
     commandable_ptr->dock(island_ptr);
 }
 
-// Read Island name from cin and find the corresponding island pointer.
+// Read Island name from the input and find the corresponding island pointer.
 shared_ptr<Island> Controller::read_and_get_island() {
-    string island_name = read_string(cin);
+    string island_name(read_word());
     return Model::get_instance().get_island_ptr(island_name);
 }
 
 void Controller::attack_cmd(shared_ptr<Commandable> commandable_ptr) {
-    string ship_name = read_string(cin);
+    string ship_name(read_word());
     shared_ptr<Ship> target_ship = Model::get_instance().get_ship_ptr(ship_name);
     commandable_ptr->attack(target_ship);
 }
@@ -435,7 +954,30 @@ void Controller::refuel_cmd(shared_ptr<Commandable> commandable_ptr) {
     commandable_ptr->refuel();
 }
 
+/* route <speed> <waypoint> ...: go to each waypoint in turn at speed, where a waypoint
+ is an island or a position x,y. The waypoints go on as long as the words on the line
+ are waypoints, so another command may follow them. */
+void Controller::route_cmd(shared_ptr<Commandable> commandable_ptr) {
+    double speed = read_speed();
+    Order_recorder legs;
+    do {
+        std::string_view word = read_word();
+        double numbers[2];
+        if (Model::get_instance().is_island_present(string(word)))
+            legs.set_destination_island_and_speed(Model::get_instance().get_island_ptr(string(word)), speed);
+        else if (read_numbers(word, numbers, 2))
+            legs.set_destination_position_and_speed(Point(numbers[0], numbers[1]), speed);
+        else
+            throw Error("Expected an island or x,y!");
+    } while (is_waypoint(reader->peek_word_on_line()));
+    const std::vector<Order>& orders = legs.get_orders();
+    commandable_ptr->clear_orders();
+    orders.front().carry_out(*commandable_ptr);
+    commandable_ptr->queue_orders(std::vector<Order>(orders.begin() + 1, orders.end()));
+}
+
 void Controller::stop_cmd(shared_ptr<Commandable> commandable_ptr) {
+    commandable_ptr->clear_orders();
     commandable_ptr->stop();
 }
 
@@ -443,9 +985,31 @@ void Controller::stop_attack_cmd(shared_ptr<Commandable> commandable_ptr) {
     commandable_ptr->stop_attack();
 }
 
+void Controller::side_cmd(shared_ptr<Commandable> commandable_ptr) {
+    commandable_ptr->set_side(string(read_word()));
+}
+
+// patrol within a radius, or stop patrolling with "off"
+void Controller::patrol_cmd(shared_ptr<Commandable> commandable_ptr) {
+    string first_word(read_word());
+    if (first_word == "off") {
+        commandable_ptr->patrol(0.);
+        return;
+    }
+    double radius;
+    std::istringstream radius_is(first_word);
+    if (!(radius_is >> radius))
+        throw Error("Expected a double!");
+    if (radius <= 0.)
+        throw Error("Radius must be positive!");
+    commandable_ptr->patrol(radius);
+}
+
 void Controller::reset() {
     map_view.reset();
     sailing_view.reset();
     bridge_views.clear();
+    gps_views.clear();
+    fleet_view.reset();
     Model::get_instance().reset();
 }
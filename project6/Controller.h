@@ -1,8 +1,11 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include "Command_reader.h"
+
 #include <map>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <list>
 #include <iosfwd>
@@ -20,9 +23,14 @@ class Sailing_view;
 class Bridge_view;
 class Commandable;
 class GPS_view;
+class Fleet_view;
 
 class Controller {
 public:
+    // read commands from cin, or from input
+    Controller();
+    explicit Controller(std::istream& input);
+    
 	// create View object, run the program by acccepting user commands, then destroy View object
 	void run();
 
@@ -33,9 +41,16 @@ private:
     std::shared_ptr<Sailing_view> sailing_view;
     std::map<std::string, std::shared_ptr<Bridge_view>> bridge_views;
     std::map<std::string, std::shared_ptr<GPS_view>> gps_views;
+    std::shared_ptr<Fleet_view> fleet_view;
+    Command_reader input_reader;
+    Command_reader* reader = &input_reader;  // the input, or the script being sourced
+    int source_depth = 0;
+
+    bool running_scheduled = false;         // are scheduled commands being run?
 
-    template<typename T>
-    T get_func_ptr(std::map<std::string, T> cmds, const std::string& cmd_word);
+    void run_commands(long& executed, long& errors);
+    bool run_command();
+    void run_scheduled_commands(const std::string& commands);
 
     void quit_cmd();
     
@@ -50,21 +65,37 @@ private:
     void open_sailing_view();
     void close_sailing_view();
     void open_bridge_view();
+    void open_bridge_view(const std::string& ship_name);
     void close_bridge_view();
     void check_map_is_open();
     void open_gps_view();
+    void open_gps_view(const std::string& ship_name);
     void close_gps_view();
     void default_gps_cmd();
     void size_gps_cmd();
     void zoom_gps_cmd();
+    void open_fleet_view();
+    void close_fleet_view();
+    void open_log_file();
+    void close_log_file();
     std::shared_ptr<GPS_view> get_open_gps_map();
     
     /* Model Command Function */
     void status_cmd();
     void go_cmd();
+    void at_cmd();
+    void every_cmd();
     void create_cmd();
+    void create_fleet_cmd();
     void save_cmd();
     void restore_cmd();
+    void source_cmd();
+    void scenario_cmd();
+    void cpa_report_cmd();
+    void cpa_alert_cmd();
+    void cruise_itinerary_cmd();
+    void combat_mode_cmd();
+    void log_cmd();
     
     /* Group Command Function */
     void create_group_cmd();
@@ -83,14 +114,21 @@ private:
     void refuel_cmd(std::shared_ptr<Commandable>);
     void stop_cmd(std::shared_ptr<Commandable>);
     void stop_attack_cmd(std::shared_ptr<Commandable>);
+    void side_cmd(std::shared_ptr<Commandable>);
+    void patrol_cmd(std::shared_ptr<Commandable>);
+    void route_cmd(std::shared_ptr<Commandable>);
     
     /* Auxiliary Function */
-    std::shared_ptr<Commandable> get_commandable_object(std::string name);
+    std::shared_ptr<Commandable> get_commandable_object(std::string_view name);
+    std::shared_ptr<Commandable> find_addressee(std::string_view word);
     std::shared_ptr<Island> read_and_get_island();
     double read_speed();
     double read_double();
+    int read_int();
+    std::string_view read_word();
+    std::string read_scheduled_commands();
     template <typename T>
-    T read_open_file(std::istream &);
+    T read_open_file();
     void reset();
 };
 	
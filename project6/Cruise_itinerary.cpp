@@ -0,0 +1,69 @@
+#include "Cruise_itinerary.h"
+#include "Island_index.h"
+
+#include <vector>
+#include <algorithm>
+
+using std::vector;
+
+// fill in the legs and the total from the stops
+static void measure_legs(Cruise_itinerary& itinerary, const Island_index& index);
+
+// plan a cruise from start by going to the nearest unvisited island each time
+Cruise_itinerary plan_greedy_itinerary(const Island_index& index, int start) {
+    Cruise_itinerary itinerary;
+    itinerary.start = start;
+    Island_set unvisited(index.size());
+    for (int id = 0; id < index.size(); ++id)
+        if (id != start)
+            unvisited.insert(id);
+    int current = start;
+    while (!unvisited.empty()) {
+        current = index.nearest_of(index.get_location(current), unvisited);
+        unvisited.erase(current);
+        itinerary.stops.push_back(current);
+    }
+    measure_legs(itinerary, index);
+    return itinerary;
+}
+
+/* The tour is start, stops..., start. Reversing stops[i..j] replaces the edges
+ (a, stops[i]) and (stops[j], b) with (a, stops[j]) and (stops[i], b). */
+void improve_with_two_opt(Cruise_itinerary& itinerary, const Island_index& index, int max_passes) {
+    vector<int>& stops = itinerary.stops;
+    int n = int(stops.size());
+    auto at = [&stops, &itinerary, n](int position) {
+        return position < 0 || position >= n ? itinerary.start : stops[position];
+    };
+    bool improved = true;
+    for (int pass = 0; improved && pass < max_passes; ++pass) {
+        improved = false;
+        for (int i = 0; i < n - 1; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                int a = at(i - 1), b = at(j + 1);
+                double change = index.distance(a, stops[j]) + index.distance(stops[i], b)
+                              - index.distance(a, stops[i]) - index.distance(stops[j], b);
+                // demand a real gain so that rounding cannot make it cycle
+                if (change < -1e-9) {
+                    std::reverse(stops.begin() + i, stops.begin() + j + 1);
+                    improved = true;
+                }
+            }
+        }
+    }
+    measure_legs(itinerary, index);
+}
+
+static void measure_legs(Cruise_itinerary& itinerary, const Island_index& index) {
+    itinerary.legs.clear();
+    itinerary.total_distance = 0.;
+    int previous = itinerary.start;
+    for (int stop : itinerary.stops) {
+        itinerary.legs.push_back(index.distance(previous, stop));
+        previous = stop;
+    }
+    if (!itinerary.stops.empty())
+        itinerary.legs.push_back(index.distance(previous, itinerary.start));
+    for (double leg : itinerary.legs)
+        itinerary.total_distance += leg;
+}
@@ -0,0 +1,32 @@
+#ifndef CRUISE_ITINERARY_H
+#define CRUISE_ITINERARY_H
+
+#include <vector>
+
+/* A Cruise_itinerary is the order in which a cruise that starts at an island visits
+ all the other islands before returning to it. Islands are given by their ID in the
+ Island_index. Since islands never move, the itinerary only depends on the start island
+ and can be shared by every cruise from there; Model keeps one per start island.
+
+ The greedy plan goes from each island to the nearest one not yet visited, ties going
+ to the island whose name comes first, which is how a cruise ship picks its next stop.
+ A greedy plan can be shortened with 2-opt, which reverses stretches of the tour for as
+ long as that makes it shorter.
+ */
+
+class Island_index;
+
+struct Cruise_itinerary {
+    int start = -1;
+    std::vector<int> stops;         // every island except start, in visiting order
+    std::vector<double> legs;       // legs[i] leads to stops[i]; the last one returns to start
+    double total_distance = 0.;
+};
+
+// plan a cruise from start by going to the nearest unvisited island each time
+Cruise_itinerary plan_greedy_itinerary(const Island_index& index, int start);
+
+// shorten an itinerary with 2-opt moves until none helps or max_passes is reached
+void improve_with_two_opt(Cruise_itinerary& itinerary, const Island_index& index, int max_passes = 50);
+
+#endif
@@ -2,18 +2,19 @@
 #include "Island.h"
 #include "Model.h"
 #include "Utility.h"
+#include "Cruise_itinerary.h"
+#include "Output.h"
+#include "Log.h"
 
 #include <string>
 #include <memory>
-#include <limits>
+#include <vector>
 #include <map>
 #include <iostream>
 #include <algorithm>
 
 using std::string;
 using std::shared_ptr;
-using std::numeric_limits;
-using std::cout;
 using std::endl;
 using std::map;
 using std::copy;
@@ -31,10 +32,11 @@ Cruise_ship::Cruise_ship(std::istream& is): Ship(is), cruise_state((Cruise_state
         init_island = read_island_ptr(is);
     }
     int list_size = read_int(is);
+    std::vector<shared_ptr<Island>> remaining;
     while (list_size--) {
-        unvisited_island.push_back(read_island_ptr(is));
+        remaining.push_back(read_island_ptr(is));
     }
-    
+    follow_itinerary_if_matching(remaining);
 }
 
 // perform Cruise_ship specific behavior
@@ -46,10 +48,11 @@ void Cruise_ship::update() {
         && !is_moving() && can_dock(get_destination_Island())) {
         dock(get_destination_Island());
         // the cruise is over
-        if (get_location() == init_island->get_location() && unvisited_island.empty()) {
-            cout << get_name() << " cruise is over at " << init_island->get_name() << endl;
+        if (get_location() == init_island->get_location() && all_visited()) {
+            SIM_LOG(detail, movement) << get_name() << " cruise is over at " << init_island->get_name() << endl;
             cruise_state = Cruise_state::not_cruising;
             init_island = nullptr;
+            itinerary = nullptr;
             return;
         }
         cruise_state = Cruise_state::refueling;
@@ -63,16 +66,20 @@ void Cruise_ship::update() {
     }
 }
 
+string Cruise_ship::get_type() const {
+    return "Cruise_ship";
+}
+
 // perform Cruise_ship specific behavior
 void Cruise_ship::describe() const {
-    cout << "\nCruise_ship ";
+    out << "\nCruise_ship ";
     Ship::describe();
     if (cruise_state == Cruise_state::not_cruising)
         return;
     else if (cruise_state == Cruise_state::moving_to_destination)
-        cout << "On cruise to " << get_destination_Island()->get_name() << endl;
+        out << "On cruise to " << get_destination_Island()->get_name() << endl;
     else
-        cout << "Waiting during cruise at " << get_destination_Island()->get_name() << endl;
+        out << "Waiting during cruise at " << get_destination_Island()->get_name() << endl;
 }
 
 // Cancel the current cruise and start a new cruise when arrives at island
@@ -80,14 +87,13 @@ void Cruise_ship::set_destination_island_and_speed(shared_ptr<Island> destinatio
                                                    double speed) {
     cancel_cruise();
     Ship::set_destination_island_and_speed(destination_island, speed);
-    cout << get_name() << " will visit " << get_destination_Island()->get_name() << endl;
+    SIM_LOG(info, movement) << get_name() << " will visit " << get_destination_Island()->get_name() << endl;
     if (cruise_state == Cruise_state::not_cruising) {
         init_island = destination_island;
-        for (auto& island : Model::get_instance().get_all_islands())
-            if (island != destination_island)
-                unvisited_island.push_back(island);
-        cout << get_name() << " cruise will start and end at ";
-        cout << destination_island->get_name() << endl;
+        itinerary = Model::get_instance().get_cruise_itinerary(destination_island);
+        next_stop = 0;
+        SIM_LOG(info, movement) << get_name() << " cruise will start and end at "
+                                << destination_island->get_name() << endl;
     }
     cruise_state = Cruise_state::moving_to_destination;
     cruise_speed = speed;
@@ -122,8 +128,16 @@ void Cruise_ship::save(std::ostream &os) const {
     } else {
         os << "no island ptr" << endl;
     }
-    os << unvisited_island.size() << endl;
-    std::for_each(unvisited_island.begin(), unvisited_island.end(), [&os](const std::shared_ptr<Island>& island_ptr){os << island_ptr->get_name() << " ";});
+    if (itinerary) {
+        const Island_index& index = Model::get_instance().get_island_index();
+        os << itinerary->stops.size() - next_stop << endl;
+        for (auto iter = itinerary->stops.begin() + next_stop; iter != itinerary->stops.end(); ++iter)
+            os << index.get_island(*iter)->get_name() << " ";
+    } else {
+        const Island_index& index = Model::get_instance().get_island_index();
+        os << unvisited_islands.size() << endl;
+        unvisited_islands.for_each([&os, &index](int id){os << index.get_island(id)->get_name() << " ";});
+    }
     os << endl;
 }
 
@@ -132,7 +146,9 @@ Cruise_ship& Cruise_ship::operator= (const Cruise_ship& in_cruise) {
     cruise_state = in_cruise.cruise_state;
     cruise_speed = in_cruise.cruise_speed;
     init_island = in_cruise.init_island;
-    unvisited_island = in_cruise.unvisited_island;
+    itinerary = in_cruise.itinerary;
+    next_stop = in_cruise.next_stop;
+    unvisited_islands = in_cruise.unvisited_islands;
     return *this;
     
 }
@@ -143,30 +159,57 @@ void Cruise_ship::cancel_cruise() {
     if (cruise_state == Cruise_state::not_cruising
         || cruise_state == Cruise_state::ready_to_go)
         return;
-    cout << get_name() << " canceling current cruise" << endl;
+    SIM_LOG(info, movement) << get_name() << " canceling current cruise" << endl;
     cruise_state = Cruise_state::not_cruising;
     init_island = nullptr;
-    unvisited_island.clear();
+    itinerary = nullptr;
+    next_stop = 0;
+    unvisited_islands.clear();
+}
+
+// Return true if every island of the cruise has been visited
+bool Cruise_ship::all_visited() const {
+    if (itinerary)
+        return next_stop == int(itinerary->stops.size());
+    return unvisited_islands.empty();
 }
 
 /* Find the nearest unvisited island and remove it from the set.
  If all islands has been visited, return initial island. */
 shared_ptr<Island> Cruise_ship::get_next_Island() {
-    if (unvisited_island.empty())
+    if (all_visited())
         return init_island;
-    auto next_island_iter = unvisited_island.begin();
-    double shortest_distance = numeric_limits<double>::max();
-    for (auto iter = unvisited_island.begin(); iter != unvisited_island.end(); ++iter) {
-        double distance = cartesian_distance(get_location(), (*iter)->get_location());
-        if (distance > shortest_distance)
-            continue;
-        if (distance < shortest_distance ||
-            (*iter)->get_name() < (*next_island_iter)->get_name()) {
-            shortest_distance = distance;
-            next_island_iter = iter;
-        }
+    const Island_index& index = Model::get_instance().get_island_index();
+    if (itinerary)
+        return index.get_island(itinerary->stops[next_stop++]);
+    int next_id = index.nearest_of(get_location(), unvisited_islands);
+    unvisited_islands.erase(next_id);
+    return index.get_island(next_id);
+}
+
+/* A saved cruise lists its remaining islands in the order it will visit them. If they
+ are the end of the itinerary from init_island, follow the itinerary from there;
+ otherwise keep visiting the nearest remaining island. */
+void Cruise_ship::follow_itinerary_if_matching(const std::vector<shared_ptr<Island>>& remaining) {
+    if (!init_island)
+        return;
+    auto planned = Model::get_instance().get_cruise_itinerary(init_island);
+    const Island_index& index = Model::get_instance().get_island_index();
+    int first = int(planned->stops.size()) - int(remaining.size());
+    bool matching = first >= 0;
+    for (std::size_t i = 0; matching && i < remaining.size(); ++i)
+        matching = index.get_id(remaining[i]) == planned->stops[first + i];
+    if (matching) {
+        itinerary = planned;
+        next_stop = first;
+        return;
     }
-    shared_ptr<Island> next_island(*next_island_iter);
-    unvisited_island.erase(next_island_iter);
-    return next_island;
+    unvisited_islands = Island_set(index.size());
+    for (const auto& island : remaining)
+        unvisited_islands.insert(index.get_id(island));
+}
+
+// the ship is idle only when it is not on a cruise
+bool Cruise_ship::is_idle() const {
+    return Ship::is_idle() && cruise_state == Cruise_state::not_cruising;
 }
@@ -2,12 +2,14 @@
 #define CRUISE_SHIP_H
 
 #include "Ship.h"
+#include "Island_set.h"
 
 #include <string>
 #include <memory>
-#include <list>
+#include <vector>
 
 enum class Cruise_state;
+struct Cruise_itinerary;
 
 class Cruise_ship : public Ship {
 public:
@@ -19,6 +21,7 @@ public:
     void update() override;
     
     void describe() const override;
+    std::string get_type() const override;
 
     // Cancel the current cruise and start a new cruise when arrives at island
     void set_destination_position_and_speed(Point destination_point, double speed) override;
@@ -37,14 +40,24 @@ public:
     Cruise_ship& operator= (const Cruise_ship&);
     
 private:
+    // the ship is idle only when it is not on a cruise
+    bool is_idle() const override;
+    
     Cruise_state cruise_state;
     double cruise_speed = 0.;
     std::shared_ptr<Island> init_island;
-    std::list<std::shared_ptr<Island>> unvisited_island;
+    // the itinerary is shared with other cruises from init_island;
+    // next_stop is the position in it of the next island to visit
+    std::shared_ptr<const Cruise_itinerary> itinerary;
+    int next_stop = 0;
+    // the remaining islands of a cruise restored from a save that is off its itinerary
+    Island_set unvisited_islands;
     
     /* Helper functions */
     void cancel_cruise();
+    bool all_visited() const;
     std::shared_ptr<Island> get_next_Island();
+    void follow_itinerary_if_matching(const std::vector<std::shared_ptr<Island>>& remaining);
 };
 
 #endif
\ No newline at end of file
@@ -1,8 +1,9 @@
 #include "Cruiser.h"
+#include "Output.h"
+#include "Log.h"
 #include <iostream>
 #include <memory>
 
-using std::cout;
 using std::endl;
 using std::shared_ptr;
 
@@ -12,21 +13,25 @@ Warships(name_, position_, 1000., 20., 10., 6., 3, 15)
 
 Cruiser::Cruiser(std::istream& is): Warships(is) {}
 
+std::string Cruiser::get_type() const {
+    return "Cruiser";
+}
+
 void Cruiser::describe() const {
-    cout << "\nCruiser ";
+    out << "\nCruiser ";
     Warships::describe();
 }
 
 // When target is out of range, cruiser will stop attacking.
 void Cruiser::target_out_of_range(shared_ptr<Ship> target) {
-    cout << get_name() << " target is out of range" << endl;
+    SIM_LOG(detail, combat) << get_name() << " target is out of range" << endl;
     stop_attack();
 }
 
-// Will counter-attack if received hit
+// Will counter-attack if received hit, unless the attacker was sunk in the same batch
 void Cruiser::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr) {
     Ship::receive_hit(hit_force, attacker_ptr);
-    if (is_afloat() && !is_attacking())
+    if (is_afloat() && !is_attacking() && attacker_ptr->is_afloat())
         attack(attacker_ptr);
 }
 
@@ -21,6 +21,7 @@ public:
     Cruiser(const std::string& name_, Point position_);
     Cruiser(std::istream &);
     void describe() const override;
+    std::string get_type() const override;
     
     // Will counter-attack if received hit
     void receive_hit(int hit_force, std::shared_ptr<Ship> attacker_ptr) override;
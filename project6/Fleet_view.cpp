@@ -0,0 +1,156 @@
+#include "Fleet_view.h"
+#include "Ship.h"
+#include "Output.h"
+
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using std::endl;
+using std::string;
+using std::make_pair;
+
+// the states in the order they are listed, with the names they are listed under
+const std::pair<Ship_state, const char*> state_names_c[] = {
+    {Ship_state::moving_to_position, "Moving to position"},
+    {Ship_state::moving_to_island, "Moving to island"},
+    {Ship_state::moving_on_course, "Moving on course"},
+    {Ship_state::stopped, "Stopped"},
+    {Ship_state::docked, "Docked"},
+    {Ship_state::dead_in_the_water, "Dead in the water"},
+    {Ship_state::sunk, "Sunk"}
+};
+
+Fleet_view::Fleet_view() {
+    for (const auto& state_name : state_names_c)
+        state_counts[state_name.first] = 0;
+}
+
+// prints out the fleet totals
+void Fleet_view::draw() const {
+    out << "----- Fleet Summary -----" << endl;
+    out << "Ships: " << ships.size() << ", attacking: " << attacking_count << endl;
+    for (const auto& type_count : type_counts)
+        if (type_count.second > 0)
+            out << field_width(20) << type_count.first << field_width(8) << type_count.second << endl;
+    for (const auto& state_name : state_names_c) {
+        int count = state_counts.at(state_name.first);
+        if (count > 0)
+            out << field_width(20) << state_name.second << field_width(8) << count << endl;
+    }
+    out << "Fuel: " << total_fuel << " tons total";
+    if (!fuel_levels.empty())
+        out << ", " << fuel_levels.begin()->first << " tons minimum";
+    out << endl;
+    out << "Island fuel reserves: " << total_island_fuel << " tons" << endl;
+}
+
+// Forget the ship; no error if the name is not present.
+void Fleet_view::update_remove(const string& name) {
+    auto iter = ships.find(name);
+    if (iter == ships.end())
+        return;
+    Ship_record& record = iter->second;
+    --record.type->second;
+    --state_counts[record.state];
+    if (record.has_fuel)
+        remove_fuel_level(record.fuel);
+    total_fuel -= record.fuel;
+    if (record.attacking)
+        --attacking_count;
+    ships.erase(iter);
+}
+
+// Count the ship under its kind and state
+void Fleet_view::update_ship_state(const string& name, const string& type, Ship_state state) {
+    auto iter = ships.find(name);
+    if (iter == ships.end()) {
+        Ship_record record;
+        record.type = type_counts.insert(make_pair(type, 0)).first;
+        ++record.type->second;
+        record.state = state;
+        ++state_counts[state];
+        ships.insert(make_pair(name, record));
+        return;
+    }
+    --state_counts[iter->second.state];
+    iter->second.state = state;
+    ++state_counts[state];
+}
+
+// Count the ship as attacking or not
+void Fleet_view::update_attacking(const string& name, bool attacking) {
+    auto iter = ships.find(name);
+    if (iter == ships.end() || iter->second.attacking == attacking)
+        return;
+    iter->second.attacking = attacking;
+    attacking_count += attacking ? 1 : -1;
+}
+
+// Account for the ship's new amount of fuel
+void Fleet_view::update_fuel(const string& name, double fuel) {
+    auto iter = ships.find(name);
+    if (iter == ships.end())
+        return;
+    Ship_record& record = iter->second;
+    if (record.has_fuel)
+        remove_fuel_level(record.fuel);
+    add_fuel_level(fuel);
+    total_fuel += fuel - record.fuel;
+    record.fuel = fuel;
+    record.has_fuel = true;
+}
+
+// Account for many objects at once; a new ship is counted in one step
+void Fleet_view::update_states(const std::vector<Object_state>& states) {
+    ships.reserve(ships.size() + states.size());
+    for (const auto& state : states) {
+        if (!state.is_ship) {
+            update_island_fuel(state.name, state.fuel);
+            continue;
+        }
+        if (ships.count(state.name)) {
+            update_ship_state(state.name, state.type, state.ship_state);
+            update_attacking(state.name, state.attacking);
+            update_fuel(state.name, state.fuel);
+            continue;
+        }
+        Ship_record record;
+        record.type = type_counts.insert(make_pair(state.type, 0)).first;
+        ++record.type->second;
+        record.state = state.ship_state;
+        ++state_counts[state.ship_state];
+        record.fuel = state.fuel;
+        record.has_fuel = true;
+        add_fuel_level(state.fuel);
+        total_fuel += state.fuel;
+        record.attacking = state.attacking;
+        if (state.attacking)
+            ++attacking_count;
+        ships.insert(make_pair(state.name, record));
+    }
+}
+
+// Account for the island's new amount of fuel
+void Fleet_view::update_island_fuel(const string& name, double fuel) {
+    double& island = island_fuel[name];
+    total_island_fuel += fuel - island;
+    island = fuel;
+}
+
+// count a ship at a fuel level
+void Fleet_view::add_fuel_level(double fuel) {
+    ++fuel_levels[fuel];
+}
+
+// stop counting a ship at a fuel level; a level no ship is at is dropped
+void Fleet_view::remove_fuel_level(double fuel) {
+    auto iter = fuel_levels.find(fuel);
+    if (--iter->second == 0)
+        fuel_levels.erase(iter);
+}
+
+// the totals are rebuilt from the Model when a saved Fleet_view is restored
+void Fleet_view::save(std::ostream& os) const {
+    os << "Fleet_view" << endl;
+}
@@ -0,0 +1,74 @@
+#ifndef FLEET_VIEW_H
+#define FLEET_VIEW_H
+
+#include "View.h"
+
+#include <map>
+#include <unordered_map>
+#include <string>
+
+/* *** Fleet_view class ***
+ Fleet_view shows the fleet as a whole: how many ships there are of each kind and
+ in each state, their total and minimum fuel, how many are attacking, and how much
+ fuel the islands hold. The totals are kept up to date from the notifications,
+ so each notification does a constant amount of bookkeeping, apart from the minimum
+ fuel, which is kept by counting the ships at each fuel level in an ordered map, so a
+ change of fuel is logarithmic. Drawing never looks at individual ships. A ship's fuel
+ is counted once a notification has told it.
+ */
+
+enum class Ship_state;
+
+class Fleet_view : public View {
+public:
+    Fleet_view();
+
+    // prints out the fleet totals
+    void draw() const override;
+
+    // Forget the ship; no error if the name is not present.
+    void update_remove(const std::string& name) override;
+
+    // Count the ship under its kind and state
+    void update_ship_state(const std::string& name, const std::string& type,
+                           Ship_state state) override;
+
+    // Count the ship as attacking or not
+    void update_attacking(const std::string& name, bool attacking) override;
+
+    // Account for the ship's new amount of fuel
+    void update_fuel(const std::string& name, double fuel) override;
+
+    // Account for the island's new amount of fuel
+    void update_island_fuel(const std::string& name, double fuel) override;
+
+    // Account for many objects at once; a new ship is counted in one step
+    void update_states(const std::vector<Object_state>& states) override;
+
+    // Save the current view status to os
+    void save(std::ostream& os) const override;
+
+private:
+    struct Ship_record {
+        std::map<std::string, int>::iterator type;
+        Ship_state state;
+        double fuel = 0.;
+        bool has_fuel = false;          // has its fuel been told yet?
+        bool attacking = false;
+    };
+
+    std::unordered_map<std::string, Ship_record> ships;
+    std::map<std::string, int> type_counts;
+    std::map<Ship_state, int> state_counts;
+    std::map<double, int> fuel_levels;  // the number of ships with each amount of fuel
+    double total_fuel = 0.;
+    int attacking_count = 0;
+    std::unordered_map<std::string, double> island_fuel;
+    double total_island_fuel = 0.;
+
+    // count a ship at a fuel level, or stop counting it there
+    void add_fuel_level(double fuel);
+    void remove_fuel_level(double fuel);
+};
+
+#endif
@@ -1,10 +1,10 @@
 #include "GPS_view.h"
 #include "Geometry.h"
 #include "Utility.h"
+#include "Output.h"
 #include <iostream>
 #include <cmath>
 
-using std::cout;
 using std::endl;
 using std::string;
 using std::vector;
@@ -55,6 +55,17 @@ void GPS_view::update_location(const string& name, Point location) {
     }
 }
 
+// Save the locations of many objects at once, and follow the ship if it is among them
+void GPS_view::update_states(const std::vector<Object_state>& states) {
+    Grid_view::update_states(states);
+    for (const auto& state : states) {
+        if (state.name == ship_name) {
+            update_location(state.name, state.location);
+            update_course(state.name, state.course);
+        }
+    }
+}
+
 // change the state to sunk if name is the GPS view name
 void GPS_view::update_remove(const string& name) {
     Grid_view::update_remove(name);
@@ -82,13 +93,13 @@ vector<vector<string>> GPS_view::get_initial_map() const {
 }
 
 // print out the text info before the real grid map.
-void GPS_view::print_map_info(vector<string> outsider) const {
-    cout << "GPS view from " << ship_name;
+void GPS_view::print_map_info(const vector<string>& drawn, int outsider_count) const {
+    out << "GPS view from " << ship_name;
     if (is_sunk)
-        cout << " sunk at " << ship_location << endl;
+        out << " sunk at " << ship_location << endl;
     else
-        cout << " position " << ship_location << " heading " << ship_heading << endl;
-    cout << "Display size: " << get_size() << ", scale: " << get_scale()
+        out << " position " << ship_location << " heading " << ship_heading << endl;
+    out << "Display size: " << get_size() << ", scale: " << get_scale()
     << ", origin: " << get_origin() << endl;
 }
 
@@ -102,6 +113,14 @@ Point GPS_view::get_relative_location(Point location) const {
     return Point(x + ship_location.x, y + ship_location.y);
 }
 
+/* The map is rotated around the ship, so take a square around the ship that
+ holds the grid at any heading. */
+void GPS_view::get_viewport(Point& lower_left, Point& upper_right) const {
+    double reach = (get_size() + 1) * get_scale();
+    lower_left = Point(ship_location.x - reach, ship_location.y - reach);
+    upper_right = Point(ship_location.x + reach, ship_location.y + reach);
+}
+
 // if (ix, iy) is further than radius to center, no need to update the grid map.
 void GPS_view::update_map(vector<vector<string>>& grid_map,
                           int ix, int iy, const std::string& name) const {
@@ -1,137 +1,344 @@
 #ifndef GEOMETRY_H
 #define GEOMETRY_H
 
-#include <iosfwd>
+#include "Geometry_fwd.h"
+
+#include <ostream>
 
 /*
-This set of simple classes is used to compute positions and directions in the plane, 
+This set of simple classes is used to compute positions and directions in the plane,
 in both cartesian and polar coordinates.
 
 These classes are defined with "struct" to make all members public by default.
 
 These classes make no assumptions about units of measurement of distance. Angles
-can be specified in radians, but radians can be converted to and from 
-trigonometry degrees in which 0 degrees corresponds to (x > 0, y = 0), 
+can be specified in radians, but radians can be converted to and from
+trigonometry degrees in which 0 degrees corresponds to (x > 0, y = 0),
 and 90 degrees corresponds to (x = 0, y > 0).
 
-Point is a set of (x, y) coordinates. 
+Point is a set of (x, y) coordinates.
 
 A Cartesian_vector is (delta_x, delta_y) - a displacement in Cartesian coordinates.
 
 A Polar_vector is (r, theta) - a displacement in polar coordinates using radians.
 
 Various overloaded operators support computations of positions and directions.
+
+Each class is a template on its scalar type and on the math policy (see Math_policy.h)
+that supplies sqrt and the trigonometric functions. Point, Cartesian_vector and
+Polar_vector use double and the default policy; Point_f and the other _f names use float.
+Classes with different scalars or policies do not mix, but a Point, Cartesian_vector
+or Polar_vector can be explicitly converted to another scalar type.
+The policy computes in double, so the float classes only save space, not work.
+
+Everything is defined in this header so that it can be inlined where it is used,
+and the parts that need no math policy are constexpr.
 */
 
-// angle units conversion functions
-double to_radians(double theta_d);
-double to_degrees(double theta_r);
+// pi, to the precision of a double
+constexpr double pi = 3.14159265358979323846;
 
+// angle units conversion functions
+// There are 2pi radians in 360 degrees
+template <typename T>
+constexpr T to_radians(T theta_d)
+{
+	return T(2. * pi * (theta_d / 360.));
+}
 
-// forward class declarations
-struct Cartesian_vector;
-struct Polar_vector;
+template <typename T>
+constexpr T to_degrees(T theta_r)
+{
+	return T(360. * theta_r / (2. * pi));
+}
 
 
 /* Point */
 // A Point contains an (x, y) pair to represent coordinates
-struct Point
+template <typename T, typename Math>
+struct Basic_point
 {
-	double x;
-	double y;
-	
-	Point (double x_ = 0., double y_ = 0.) :
+	using scalar_type = T;
+
+	T x;
+	T y;
+
+	constexpr Basic_point (T x_ = 0., T y_ = 0.) :
 		x(x_), y(y_)
 		{}
 
+	// convert a Point with another scalar type
+	template <typename U>
+	constexpr explicit Basic_point (const Basic_point<U, Math>& p) :
+		x(T(p.x)), y(T(p.y))
+		{}
+
 	// compare two Points
-	bool operator== (const Point& rhs) const;
-	bool operator!= (const Point& rhs) const;	
+	constexpr bool operator== (const Basic_point& rhs) const
+		{return (x == rhs.x && y == rhs.y);}
+	constexpr bool operator!= (const Basic_point& rhs) const
+		{return (x != rhs.x || y != rhs.y);}
 };
 
 // return the distance between two Points
-double cartesian_distance (const Point& p1, const Point& p2);
+template <typename T, typename Math>
+inline T cartesian_distance (const Basic_point<T, Math>& p1, const Basic_point<T, Math>& p2)
+{
+	T xd = p2.x - p1.x;
+	T yd = p2.y - p1.y;
+	T d = T(Math::sqrt(xd * xd + yd * yd));
+	return d;
+}
 
 /* Cartesian_vector */
 // A Cartesian_vector contains an x, y displacement
-struct Cartesian_vector
+template <typename T, typename Math>
+struct Basic_cartesian_vector
 {
-	double delta_x;
-	double delta_y;
+	using scalar_type = T;
+
+	T delta_x;
+	T delta_y;
 
-	Cartesian_vector (double delta_x_ = 0., double delta_y_ = 0.) : 
+	constexpr Basic_cartesian_vector (T delta_x_ = 0., T delta_y_ = 0.) :
 		delta_x(delta_x_), delta_y(delta_y_)
 	{}
 
+	// convert a Cartesian_vector with another scalar type
+	template <typename U>
+	constexpr explicit Basic_cartesian_vector (const Basic_cartesian_vector<U, Math>& cv) :
+		delta_x(T(cv.delta_x)), delta_y(T(cv.delta_y))
+	{}
+
 	// construct a Cartesian_vector from two Points,
-	// showing the vector from p1 to p2 
+	// showing the vector from p1 to p2
 	// that is, p1 + cv => p2
-	Cartesian_vector(const Point& p1, const Point& p2);
+	constexpr Basic_cartesian_vector(const Basic_point<T, Math>& p1, const Basic_point<T, Math>& p2) :
+		delta_x(p2.x - p1.x), delta_y(p2.y - p1.y)
+	{}
 
 	// construct a Cartesian_vector from a Polar_vector
-	Cartesian_vector(const Polar_vector& pv);
+	Basic_cartesian_vector(const Basic_polar_vector<T, Math>& pv) :
+		delta_x(T(pv.r * Math::cos(pv.theta))), delta_y(T(pv.r * Math::sin(pv.theta)))
+	{}
 };
 
 
 /* Polar_vector */
 // Polar_vector describes a displacement in terms of polar coordinates
 // with angle in radians
-struct Polar_vector
+template <typename T, typename Math>
+struct Basic_polar_vector
 {
-	double r;
-	double theta;
+	using scalar_type = T;
 
-	Polar_vector (double r_ = 0., double theta_ = 0.) : 
+	T r;
+	T theta;
+
+	constexpr Basic_polar_vector (T r_ = 0., T theta_ = 0.) :
 		r(r_), theta(theta_)
 	{}
 
+	// convert a Polar_vector with another scalar type
+	template <typename U>
+	constexpr explicit Basic_polar_vector (const Basic_polar_vector<U, Math>& pv) :
+		r(T(pv.r)), theta(T(pv.theta))
+	{}
+
 	// construct a Polar_vector from two Points,
-	// showing the vector from p1 to p2 
+	// showing the vector from p1 to p2
 	// that is, p1 + pv => p2
-	Polar_vector(const Point& p1, const Point& p2);
+	Basic_polar_vector(const Basic_point<T, Math>& p1, const Basic_point<T, Math>& p2) :
+		Basic_polar_vector(Basic_cartesian_vector<T, Math>(p1, p2))
+	{}
 
 	// construct a Polar_vector from a Cartesian_vector
-	Polar_vector(const Cartesian_vector& cv);
-
+	Basic_polar_vector(const Basic_cartesian_vector<T, Math>& cv) :
+		r(T(Math::sqrt((cv.delta_x * cv.delta_x) + (cv.delta_y * cv.delta_y)))),
+		// atan2 will return neg angle for Quadrant III, IV, must translate to I, II
+		theta(T(Math::atan2(cv.delta_y, cv.delta_x)))
+	{
+		if (theta < 0.)
+			theta = T(2. * pi + theta); // normalize theta positive
+	}
 };
 
 // *** Overloaded Operators ***
+// The scalar operand of * and / has the vector's scalar type but is not used to deduce it,
+// so that a plain double or int can scale a float vector.
 
 // Subtract two Points to get a Cartesian_vector
 // p2's components are subtracted from p1
-Cartesian_vector operator- (const Point& p1, const Point& p2);
+template <typename T, typename Math>
+constexpr Basic_cartesian_vector<T, Math> operator- (const Basic_point<T, Math>& p1, const Basic_point<T, Math>& p2)
+{
+	return Basic_cartesian_vector<T, Math>(p1.x - p2.x, p1.y - p2.y);
+}
 
 // Add a Point and a Cartesian_vector to get the displaced Point
-Point operator+ (const Point& p, const Cartesian_vector& cv);
-Point operator+ (const Cartesian_vector& cv, const Point& p);
-	
+template <typename T, typename Math>
+constexpr Basic_point<T, Math> operator+ (const Basic_point<T, Math>& p, const Basic_cartesian_vector<T, Math>& cv)
+{
+	return Basic_point<T, Math>(p.x + cv.delta_x, p.y + cv.delta_y);
+}
+
+template <typename T, typename Math>
+constexpr Basic_point<T, Math> operator+ (const Basic_cartesian_vector<T, Math>& cv, const Basic_point<T, Math>& p)
+{
+	return p + cv;
+}
+
 // Add a Point and a Polar_vector to get the displaced Point
-Point operator+ (const Point& p, const Polar_vector& pv);
-Point operator+ (const Polar_vector& pv, const Point& p);
+template <typename T, typename Math>
+inline Basic_point<T, Math> operator+ (const Basic_point<T, Math>& p, const Basic_polar_vector<T, Math>& pv)
+{
+	Basic_cartesian_vector<T, Math> cv (pv);
+	return cv + p;
+}
+
+template <typename T, typename Math>
+inline Basic_point<T, Math> operator+ (const Basic_polar_vector<T, Math>& pv, const Basic_point<T, Math>& p)
+{
+	return p + pv;
+}
 
 // Adding or subtracting two Cartesian_vectors adds or subtracts the components
-Cartesian_vector operator+ (const Cartesian_vector& cv1, const Cartesian_vector& cv2);
-Cartesian_vector operator- (const Cartesian_vector& cv1, const Cartesian_vector& cv2);
+template <typename T, typename Math>
+constexpr Basic_cartesian_vector<T, Math> operator+ (const Basic_cartesian_vector<T, Math>& cv1, const Basic_cartesian_vector<T, Math>& cv2)
+{
+	return Basic_cartesian_vector<T, Math>(cv1.delta_x + cv2.delta_x, cv1.delta_y + cv2.delta_y);
+}
+
+template <typename T, typename Math>
+constexpr Basic_cartesian_vector<T, Math> operator- (const Basic_cartesian_vector<T, Math>& cv1, const Basic_cartesian_vector<T, Math>& cv2)
+{
+	return Basic_cartesian_vector<T, Math>(cv1.delta_x - cv2.delta_x, cv1.delta_y - cv2.delta_y);
+}
 
 // divide a Cartesian_vector by a double: divide each component by the double
-Cartesian_vector operator/ (const Cartesian_vector& cv, double d);
-Cartesian_vector operator/ (double d, const Cartesian_vector& cv);
+template <typename T, typename Math>
+constexpr Basic_cartesian_vector<T, Math> operator/ (const Basic_cartesian_vector<T, Math>& cv,
+	typename Basic_cartesian_vector<T, Math>::scalar_type d)
+{
+	return Basic_cartesian_vector<T, Math>(cv.delta_x / d, cv.delta_y / d);
+}
+
+template <typename T, typename Math>
+constexpr Basic_cartesian_vector<T, Math> operator/ (typename Basic_cartesian_vector<T, Math>::scalar_type d,
+	const Basic_cartesian_vector<T, Math>& cv)
+{
+	return cv / d;
+}
 
 // divide a Polar_vector by a double: divide r component by the double
-Polar_vector operator/ (const Polar_vector& pv, double d);
-Polar_vector operator/ (double d, const Polar_vector& pv);
+template <typename T, typename Math>
+constexpr Basic_polar_vector<T, Math> operator/ (const Basic_polar_vector<T, Math>& pv,
+	typename Basic_polar_vector<T, Math>::scalar_type d)
+{
+	return Basic_polar_vector<T, Math>(pv.r / d, pv.theta);
+}
+
+template <typename T, typename Math>
+constexpr Basic_polar_vector<T, Math> operator/ (typename Basic_polar_vector<T, Math>::scalar_type d,
+	const Basic_polar_vector<T, Math>& pv)
+{
+	return pv / d;
+}
 
-// multiply a Cartesian_vector by a double: divide each component by the double
-Cartesian_vector operator* (const Cartesian_vector& cv, double d);
-Cartesian_vector operator* (double d, const Cartesian_vector& cv);
+// multiply a Cartesian_vector by a double: multiply each component by the double
+template <typename T, typename Math>
+constexpr Basic_cartesian_vector<T, Math> operator* (const Basic_cartesian_vector<T, Math>& cv,
+	typename Basic_cartesian_vector<T, Math>::scalar_type d)
+{
+	return Basic_cartesian_vector<T, Math>(cv.delta_x * d, cv.delta_y * d);
+}
+
+template <typename T, typename Math>
+constexpr Basic_cartesian_vector<T, Math> operator* (typename Basic_cartesian_vector<T, Math>::scalar_type d,
+	const Basic_cartesian_vector<T, Math>& cv)
+{
+	return cv * d;
+}
 
-// multiply a Polar_vector by a double: divide r component by the double
-Polar_vector operator* (const Polar_vector& pv, double d);
-Polar_vector operator* (double d, const Polar_vector& pv);
+// multiply a Polar_vector by a double: multiply r component by the double
+template <typename T, typename Math>
+constexpr Basic_polar_vector<T, Math> operator* (const Basic_polar_vector<T, Math>& pv,
+	typename Basic_polar_vector<T, Math>::scalar_type d)
+{
+	return Basic_polar_vector<T, Math>(pv.r * d, pv.theta);
+}
+
+template <typename T, typename Math>
+constexpr Basic_polar_vector<T, Math> operator* (typename Basic_polar_vector<T, Math>::scalar_type d,
+	const Basic_polar_vector<T, Math>& pv)
+{
+	return pv * d;
+}
+
+// *** Bulk conversions ***
+// These convert n vectors at a time, each kept as separate arrays of its components,
+// and give exactly what the constructors give one vector at a time. The trigonometry
+// is done by Math's sin_cos and atan2 over the arrays, so with Fast_math they are
+// several times as fast. The arrays are done a block at a time, so that each block is
+// still in the cache for the passes after the trigonometry. The output arrays must not
+// overlap the inputs.
+
+const int bulk_block_size_c = 256;
+
+// the Polar_vectors (r, theta) of the Cartesian_vectors (delta_x, delta_y)
+template <typename Math = Default_math>
+void to_polar_vectors(const double* delta_x, const double* delta_y, double* r, double* theta, int n)
+{
+	// theta is normalized positive by adding a turn or -0, which leaves any theta as it
+	// is; the sign cannot be predicted, and the compiler does not branch on a table lookup
+	static const double turns[2] = {-0., 2. * pi};
+	for (int start = 0; start < n; start += bulk_block_size_c) {
+		int end = n - start < bulk_block_size_c ? n : start + bulk_block_size_c;
+		Math::atan2(delta_y + start, delta_x + start, theta + start, end - start);
+		for (int i = start; i < end; ++i) {
+			r[i] = Math::sqrt((delta_x[i] * delta_x[i]) + (delta_y[i] * delta_y[i]));
+			theta[i] += turns[theta[i] < 0.];
+		}
+	}
+}
+
+// the Cartesian_vectors (delta_x, delta_y) of the Polar_vectors (r, theta)
+template <typename Math = Default_math>
+void to_cartesian_vectors(const double* r, const double* theta, double* delta_x, double* delta_y, int n)
+{
+	for (int start = 0; start < n; start += bulk_block_size_c) {
+		int end = n - start < bulk_block_size_c ? n : start + bulk_block_size_c;
+		Math::sin_cos(theta + start, delta_y + start, delta_x + start, end - start);
+		for (int i = start; i < end; ++i) {
+			delta_x[i] = r[i] * delta_x[i];
+			delta_y[i] = r[i] * delta_y[i];
+		}
+	}
+}
 
 // Output operators
-std::ostream& operator<< (std::ostream& os, const Point& p);
-std::ostream& operator<< (std::ostream& os, const Cartesian_vector& cv);
-std::ostream& operator<< (std::ostream& os, const Polar_vector& pv);
+// output a Point as "(x, y)"
+template <typename T, typename Math>
+std::ostream& operator<< (std::ostream& os, const Basic_point<T, Math>& p)
+{
+	os << '(' << p.x << ", " << p.y << ')';
+	return os;
+}
+
+// output a Cartesian_vector as "<x, y>"
+template <typename T, typename Math>
+std::ostream& operator<< (std::ostream& os, const Basic_cartesian_vector<T, Math>& cv)
+{
+	os << '<' << cv.delta_x << ", " << cv.delta_y << '>';
+	return os;
+}
+
+// output a Polar_vector as "P<r, theta>"
+template <typename T, typename Math>
+std::ostream& operator<< (std::ostream& os, const Basic_polar_vector<T, Math>& pv)
+{
+	os << "P<" << pv.r << ", " << pv.theta << '>';
+	return os;
+}
 
 #endif
@@ -0,0 +1,394 @@
+/*
+Micro-benchmarks for the Geometry and Navigation primitives and the Track_base
+operations built on them.
+
+Each benchmark runs an operation over a large batch of randomized inputs several
+times and keeps the fastest run, reported as nanoseconds per operation and millions
+of operations per second. The policy-dependent operations are run with both
+Exact_math and Fast_math, and the errors of Fast_math against Exact_math are
+measured on the same inputs.
+
+advance_tracks is also checked against Track_base::update_position, on whichever
+vector path the build uses, and the bulk conversions against the constructors they
+stand for, in both policies; the program returns 1 if any result differs.
+
+Usage: geometry_bench [output_file [batch_size]]
+The results are printed as a table and written to output_file (geometry_bench.json
+by default) as JSON, so that runs can be compared by a script.
+*/
+
+#include "Geometry.h"
+#include "Navigation.h"
+#include "Track_base.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using std::vector;
+using std::string;
+using std::cout;
+using std::endl;
+
+const int repetitions_c = 7;
+
+struct Result {
+	string name;
+	string policy;
+	long operations;
+	double ns_per_op;
+};
+
+struct Accuracy {
+	string name;
+	double max_abs_error;
+	string unit;
+};
+
+// Results are accumulated here so that the compiler cannot drop the work
+volatile double sink;
+
+/* Run func, which does n operations, repetitions_c times and record the fastest run */
+template <typename F>
+void run(vector<Result>& results, const string& name, const string& policy, long n, F func)
+{
+	double best = 0.;
+	for (int rep = 0; rep < repetitions_c; ++rep) {
+		auto start = std::chrono::steady_clock::now();
+		sink = func();
+		auto stop = std::chrono::steady_clock::now();
+		double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+		if (rep == 0 || ns < best)
+			best = ns;
+	}
+	results.push_back(Result{name, policy, n, best / n});
+}
+
+// The randomized inputs shared by all the benchmarks
+struct Inputs {
+	vector<double> x1, y1, x2, y2;		// pairs of points in a 1000 nm square
+	vector<double> course1, course2;	// compass degrees in [0, 360)
+	vector<double> speed1, speed2;		// knots in [0, 30]
+
+	Inputs(int n, unsigned seed)
+	{
+		std::mt19937_64 generator(seed);
+		std::uniform_real_distribution<double> coordinate(-500., 500.);
+		std::uniform_real_distribution<double> course(0., 360.);
+		std::uniform_real_distribution<double> speed(0., 30.);
+		for (auto* v : {&x1, &y1, &x2, &y2, &course1, &course2, &speed1, &speed2})
+			v->resize(n);
+		for (int i = 0; i < n; ++i) {
+			x1[i] = coordinate(generator);
+			y1[i] = coordinate(generator);
+			x2[i] = coordinate(generator);
+			y2[i] = coordinate(generator);
+			course1[i] = course(generator);
+			course2[i] = course(generator);
+			speed1[i] = speed(generator);
+			speed2[i] = speed(generator);
+		}
+	}
+};
+
+/* Benchmark the operations that depend on the math policy */
+template <typename Math>
+void run_policy_benchmarks(vector<Result>& results, const Inputs& in, const string& policy)
+{
+	using P = Basic_point<double, Math>;
+	using Cv = Basic_cartesian_vector<double, Math>;
+	using Pv = Basic_polar_vector<double, Math>;
+	using Cp = Basic_compass_position<double, Math>;
+	using Cmv = Basic_compass_vector<double, Math>;
+	using Cs = Basic_course_speed<double, Math>;
+	long n = long(in.x1.size());
+
+	run(results, "cartesian_distance", policy, n, [&] {
+		double sum = 0.;
+		for (long i = 0; i < n; ++i)
+			sum += cartesian_distance(P(in.x1[i], in.y1[i]), P(in.x2[i], in.y2[i]));
+		return sum;
+	});
+	run(results, "Polar_vector(Cartesian_vector)", policy, n, [&] {
+		double sum = 0.;
+		for (long i = 0; i < n; ++i) {
+			Pv pv(Cv(in.x1[i], in.y1[i]));
+			sum += pv.r + pv.theta;
+		}
+		return sum;
+	});
+	run(results, "Cartesian_vector(Polar_vector)", policy, n, [&] {
+		double sum = 0.;
+		for (long i = 0; i < n; ++i) {
+			Cv cv(Pv(in.speed1[i], to_radians(in.course1[i])));
+			sum += cv.delta_x + cv.delta_y;
+		}
+		return sum;
+	});
+	run(results, "Compass_position(Point, Point)", policy, n, [&] {
+		double sum = 0.;
+		for (long i = 0; i < n; ++i) {
+			Cp cp(P(in.x1[i], in.y1[i]), P(in.x2[i], in.y2[i]));
+			sum += cp.bearing + cp.range;
+		}
+		return sum;
+	});
+	run(results, "Compass_vector(Point, Point)", policy, n, [&] {
+		double sum = 0.;
+		for (long i = 0; i < n; ++i) {
+			Cmv cv(P(in.x1[i], in.y1[i]), P(in.x2[i], in.y2[i]));
+			sum += cv.direction + cv.distance;
+		}
+		return sum;
+	});
+	run(results, "Point + Compass_vector", policy, n, [&] {
+		double sum = 0.;
+		for (long i = 0; i < n; ++i) {
+			P p = P(in.x1[i], in.y1[i]) + Cs(in.course1[i], in.speed1[i]) * 0.5;
+			sum += p.x + p.y;
+		}
+		return sum;
+	});
+
+	vector<double> out1(n), out2(n);
+	run(results, "to_polar_vectors (bulk)", policy, n, [&] {
+		to_polar_vectors<Math>(in.x1.data(), in.y1.data(), out1.data(), out2.data(), int(n));
+		return out1.front() + out2.back();
+	});
+	vector<double> theta(n);
+	for (long i = 0; i < n; ++i)
+		theta[i] = to_radians(in.course1[i]);
+	run(results, "to_cartesian_vectors (bulk)", policy, n, [&] {
+		to_cartesian_vectors<Math>(in.speed1.data(), theta.data(), out1.data(), out2.data(), int(n));
+		return out1.front() + out2.back();
+	});
+	run(results, "to_compass_positions (bulk)", policy, n, [&] {
+		to_compass_positions<Math>(in.x1.data(), in.y1.data(), in.x2.data(), in.y2.data(),
+			out1.data(), out2.data(), int(n));
+		return out1.front() + out2.back();
+	});
+	run(results, "compute_CPA", policy, n, [&] {
+		double sum = 0.;
+		for (long i = 0; i < n; ++i) {
+			double time = 0.;
+			Cp cpa = compute_CPA(Cs(in.course1[i], in.speed1[i]), Cs(in.course2[i], in.speed2[i]),
+				Cp(P(in.x1[i], in.y1[i]), P(in.x2[i], in.y2[i])), time);
+			sum += cpa.range + time;
+		}
+		return sum;
+	});
+}
+
+/* Benchmark Track_base, which uses the default policy */
+void run_track_benchmarks(vector<Result>& results, const Inputs& in, const string& policy)
+{
+	long n = long(in.x1.size());
+	vector<Track_base> tracks, others;
+	tracks.reserve(n);
+	others.reserve(n);
+	for (long i = 0; i < n; ++i) {
+		tracks.push_back(Track_base(Point(in.x1[i], in.y1[i]), Course_speed(in.course1[i], in.speed1[i])));
+		others.push_back(Track_base(Point(in.x2[i], in.y2[i]), Course_speed(in.course2[i], in.speed2[i])));
+	}
+
+	run(results, "Track_base::update_position", policy, n, [&] {
+		for (auto& track : tracks)
+			track.update_position(0.01);
+		return tracks.front().get_position().x;
+	});
+	run(results, "Track_base::is_inbound_toward", policy, n, [&] {
+		double count = 0.;
+		for (long i = 0; i < n; ++i)
+			count += tracks[i].is_inbound_toward(&others[i]);
+		return count;
+	});
+
+	vector<double> x(in.x1), y(in.y1), heading_x(n), heading_y(n), speed(in.speed1);
+	for (long i = 0; i < n; ++i) {
+		heading_x[i] = tracks[i].get_heading().delta_x;
+		heading_y[i] = tracks[i].get_heading().delta_y;
+	}
+	run(results, "advance_tracks", policy, n, [&] {
+		advance_tracks(x.data(), y.data(), heading_x.data(), heading_y.data(), speed.data(), int(n), 0.01);
+		return x.front();
+	});
+}
+
+/* Return the number of tracks that advance_tracks moves to a different place than
+update_position does; they must be identical */
+long check_advance_tracks(const Inputs& in)
+{
+	long n = long(in.x1.size());
+	vector<Track_base> tracks;
+	tracks.reserve(n);
+	vector<double> x(in.x1), y(in.y1), heading_x(n), heading_y(n), speed(in.speed1);
+	for (long i = 0; i < n; ++i) {
+		tracks.push_back(Track_base(Point(in.x1[i], in.y1[i]), Course_speed(in.course1[i], in.speed1[i])));
+		heading_x[i] = tracks[i].get_heading().delta_x;
+		heading_y[i] = tracks[i].get_heading().delta_y;
+	}
+	const double time_increment = 0.37;
+	advance_tracks(x.data(), y.data(), heading_x.data(), heading_y.data(), speed.data(), int(n), time_increment);
+	long mismatches = 0;
+	for (long i = 0; i < n; ++i) {
+		tracks[i].update_position(time_increment);
+		mismatches += tracks[i].get_position().x != x[i] || tracks[i].get_position().y != y[i];
+	}
+	return mismatches;
+}
+
+bool same_bits(double a, double b)
+{
+	return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+/* Return the number of vectors and positions that the bulk conversions give differently
+from the constructors, down to the sign of a zero; they must be identical */
+template <typename Math>
+long check_bulk_conversions(const Inputs& in)
+{
+	using P = Basic_point<double, Math>;
+	using Cv = Basic_cartesian_vector<double, Math>;
+	using Pv = Basic_polar_vector<double, Math>;
+	using Cp = Basic_compass_position<double, Math>;
+	// with the points at the origin and on the axes, where atan2 has its special cases
+	vector<double> x(in.x1), y(in.y1), x2(in.x2), y2(in.y2);
+	for (double special_x : {-1., -0., 0., 1.})
+		for (double special_y : {-1., -0., 0., 1.}) {
+			x.push_back(special_x);
+			y.push_back(special_y);
+			x2.push_back(special_x);
+			y2.push_back(-special_y);
+		}
+	long n = long(x.size());
+	vector<double> out1(n), out2(n);
+	long mismatches = 0;
+	to_polar_vectors<Math>(x.data(), y.data(), out1.data(), out2.data(), int(n));
+	for (long i = 0; i < n; ++i) {
+		Pv pv(Cv(x[i], y[i]));
+		mismatches += !same_bits(pv.r, out1[i]) || !same_bits(pv.theta, out2[i]);
+	}
+	to_cartesian_vectors<Math>(x2.data(), y.data(), out1.data(), out2.data(), int(n));
+	for (long i = 0; i < n; ++i) {
+		Cv cv(Pv(x2[i], y[i]));
+		mismatches += !same_bits(cv.delta_x, out1[i]) || !same_bits(cv.delta_y, out2[i]);
+	}
+	to_compass_positions<Math>(x.data(), y.data(), x2.data(), y2.data(), out1.data(), out2.data(), int(n));
+	for (long i = 0; i < n; ++i) {
+		Cp cp(P(x[i], y[i]), P(x2[i], y2[i]));
+		mismatches += !same_bits(cp.bearing, out1[i]) || !same_bits(cp.range, out2[i]);
+	}
+	return mismatches;
+}
+
+/* Measure how far Fast_math results are from Exact_math results on the same inputs */
+vector<Accuracy> measure_accuracy(const Inputs& in)
+{
+	double sin_error = 0., cos_error = 0., atan2_error = 0., bearing_error = 0., cpa_error = 0.;
+	long n = long(in.x1.size());
+	for (long i = 0; i < n; ++i) {
+		double angle = to_radians(in.course1[i]) + in.x1[i];
+		sin_error = std::max(sin_error, std::fabs(Fast_math::sin(angle) - Exact_math::sin(angle)));
+		cos_error = std::max(cos_error, std::fabs(Fast_math::cos(angle) - Exact_math::cos(angle)));
+		atan2_error = std::max(atan2_error,
+			std::fabs(Fast_math::atan2(in.y1[i], in.x1[i]) - Exact_math::atan2(in.y1[i], in.x1[i])));
+
+		Basic_compass_position<double, Exact_math> exact(
+			Basic_point<double, Exact_math>(in.x1[i], in.y1[i]), Basic_point<double, Exact_math>(in.x2[i], in.y2[i]));
+		Basic_compass_position<double, Fast_math> fast(
+			Basic_point<double, Fast_math>(in.x1[i], in.y1[i]), Basic_point<double, Fast_math>(in.x2[i], in.y2[i]));
+		// bearings just either side of north differ by almost 360
+		double difference = std::fabs(exact.bearing - fast.bearing);
+		bearing_error = std::max(bearing_error, std::min(difference, 360. - difference));
+
+		double exact_time = 0., fast_time = 0.;
+		auto exact_cpa = compute_CPA(Basic_course_speed<double, Exact_math>(in.course1[i], in.speed1[i]),
+			Basic_course_speed<double, Exact_math>(in.course2[i], in.speed2[i]), exact, exact_time);
+		auto fast_cpa = compute_CPA(Basic_course_speed<double, Fast_math>(in.course1[i], in.speed1[i]),
+			Basic_course_speed<double, Fast_math>(in.course2[i], in.speed2[i]), fast, fast_time);
+		cpa_error = std::max(cpa_error, std::fabs(exact_cpa.range - fast_cpa.range));
+	}
+	return {
+		{"sin", sin_error, "absolute"},
+		{"cos", cos_error, "absolute"},
+		{"atan2", atan2_error, "radians"},
+		{"Compass_position bearing", bearing_error, "degrees"},
+		{"compute_CPA range", cpa_error, "nm"}
+	};
+}
+
+void write_json(std::ostream& os, const vector<Result>& results, const vector<Accuracy>& accuracy)
+{
+	os << std::setprecision(6) << "{\n  \"benchmarks\": [\n";
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		const Result& r = results[i];
+		os << "    {\"name\": \"" << r.name << "\", \"policy\": \"" << r.policy
+		   << "\", \"operations\": " << r.operations << ", \"ns_per_op\": " << r.ns_per_op
+		   << ", \"mops_per_s\": " << 1e3 / r.ns_per_op << "}"
+		   << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	os << "  ],\n  \"accuracy\": [\n";
+	for (std::size_t i = 0; i < accuracy.size(); ++i) {
+		const Accuracy& a = accuracy[i];
+		os << "    {\"name\": \"" << a.name << "\", \"max_abs_error\": " << a.max_abs_error
+		   << ", \"unit\": \"" << a.unit << "\"}"
+		   << (i + 1 < accuracy.size() ? ",\n" : "\n");
+	}
+	os << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[])
+{
+	string output_file = argc > 1 ? argv[1] : "geometry_bench.json";
+	int batch_size = argc > 2 ? std::atoi(argv[2]) : 1 << 20;
+	if (batch_size <= 0) {
+		std::cerr << "Batch size must be positive" << endl;
+		return 1;
+	}
+
+	Inputs inputs(batch_size, 381);
+	vector<Result> results;
+	run_policy_benchmarks<Exact_math>(results, inputs, "exact");
+	run_policy_benchmarks<Fast_math>(results, inputs, "fast");
+	run_track_benchmarks(results, inputs, "default");
+	vector<Accuracy> accuracy = measure_accuracy(inputs);
+#if defined(__AVX__)
+	const char* vector_path = "AVX";
+#elif defined(__SSE2__)
+	const char* vector_path = "SSE2";
+#else
+	const char* vector_path = "scalar";
+#endif
+	long mismatches = check_advance_tracks(inputs);
+	long bulk_mismatches = check_bulk_conversions<Exact_math>(inputs) + check_bulk_conversions<Fast_math>(inputs);
+
+	cout << std::left << std::setw(34) << "benchmark" << std::setw(9) << "policy"
+		 << std::right << std::setw(12) << "ns/op" << std::setw(12) << "Mops/s" << endl;
+	cout << std::fixed << std::setprecision(2);
+	for (const auto& r : results)
+		cout << std::left << std::setw(34) << r.name << std::setw(9) << r.policy
+			 << std::right << std::setw(12) << r.ns_per_op << std::setw(12) << 1e3 / r.ns_per_op << endl;
+	cout << std::scientific << std::setprecision(2);
+	for (const auto& a : accuracy)
+		cout << "fast vs exact " << std::left << std::setw(26) << a.name << std::right
+			 << std::setw(12) << a.max_abs_error << " " << a.unit << endl;
+
+	std::ofstream os(output_file);
+	if (!os) {
+		std::cerr << "Cannot open " << output_file << endl;
+		return 1;
+	}
+	write_json(os, results, accuracy);
+	cout << "advance_tracks (" << vector_path << "): " << mismatches
+		 << " tracks differ from update_position" << endl;
+	cout << "bulk conversions: " << bulk_mismatches << " results differ from the constructors" << endl;
+	return mismatches > 0 || bulk_mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+#ifndef GEOMETRY_FWD_H
+#define GEOMETRY_FWD_H
+
+#include "Math_policy.h"
+
+/*
+Forward declarations of the Geometry types and their plain names, for headers that
+only refer to them. See Geometry.h for the types themselves.
+*/
+
+template <typename T, typename Math = Default_math> struct Basic_point;
+template <typename T, typename Math = Default_math> struct Basic_cartesian_vector;
+template <typename T, typename Math = Default_math> struct Basic_polar_vector;
+
+using Point = Basic_point<double>;
+using Cartesian_vector = Basic_cartesian_vector<double>;
+using Polar_vector = Basic_polar_vector<double>;
+
+// single-precision variants, for bulk state where memory bandwidth matters more than digits
+using Point_f = Basic_point<float>;
+using Cartesian_vector_f = Basic_cartesian_vector<float>;
+using Polar_vector_f = Basic_polar_vector<float>;
+
+#endif
@@ -1,16 +1,14 @@
 #include "Grid_view.h"
 #include "Geometry.h"
 #include "Utility.h"
+#include "Output.h"
 #include <iostream>
-#include <iomanip>
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <iterator>
 
 using std::for_each;
-using std::setprecision;
-using std::setw;
-using std::cout;
 using std::endl;
 using std::string;
 using std::vector;
@@ -27,51 +25,92 @@ size(read_int(is)), scale(read_double(is)), origin(read_point(is))
     while (memory_size--) {
         std::string key;
         is >> key;
-        memory[key] = read_point(is);
+        update_location(key, read_point(is));
     }
 }
 
+Grid_view::Grid_view(const Grid_view& other) :
+View(other), size(other.size), scale(other.scale), origin(other.origin), memory(other.memory)
+{
+    for (const auto& object : memory)
+        index.insert(&object.first, object.second);
+}
+
 /* Save the supplied name and location for future use in a draw() call
  If the name is already present,the new location replaces the previous one. */
 void Grid_view::update_location(const string& name, Point location) {
-    memory[name] = location;
+    auto iter = memory.find(name);
+    if (iter == memory.end()) {
+        iter = memory.insert(std::make_pair(name, location)).first;
+        index.insert(&iter->first, location);
+    } else {
+        index.move(&iter->first, iter->second, location);
+        iter->second = location;
+    }
+}
+
+/* Save the locations of many objects at once. The states usually come in name order,
+ so each is put in right after the one before. */
+void Grid_view::update_states(const vector<Object_state>& states) {
+    if (states.empty())
+        return;
+    auto hint = memory.lower_bound(states.front().name);
+    for (const auto& state : states) {
+        auto size = memory.size();
+        auto iter = memory.try_emplace(hint, state.name, state.location);
+        if (memory.size() != size) {
+            index.insert(&iter->first, state.location);
+        } else {
+            index.move(&iter->first, iter->second, state.location);
+            iter->second = state.location;
+        }
+        hint = std::next(iter);
+    }
 }
 
 // Remove the name and its location; no error if the name is not present.
 void Grid_view::update_remove(const string& name) {
-    memory.erase(name);
+    auto iter = memory.find(name);
+    if (iter == memory.end())
+        return;
+    index.remove(&iter->first, iter->second);
+    memory.erase(iter);
 }
 
-// draw the grid map
+/* draw the grid map
+ Only the objects inside the viewport are looked at; the ones outside are just
+ counted, and their names are listed only if print_map_info asks for them. */
 void Grid_view::draw() const {
     vector<vector<string>> grid_map = get_initial_map();
-    vector<string> outsider;
-    for (const auto& object : memory) {
-        Point location = get_relative_location(object.second);
-        string name = object.first;
+    vector<string> drawn;
+    Point lower_left, upper_right;
+    get_viewport(lower_left, upper_right);
+    index.for_each_in_rect(lower_left, upper_right,
+                           [this, &grid_map, &drawn](const string* name, Point location) {
         int ix, iy;
-        if (!get_subscripts(ix, iy, location))
-            outsider.push_back(name);
-        else
-            update_map(grid_map, ix, iy, name);
-    }
+        if (get_subscripts(ix, iy, get_relative_location(location))) {
+            update_map(grid_map, ix, iy, *name);
+            drawn.push_back(*name);
+        }
+    });
+    std::sort(drawn.begin(), drawn.end());
     
-    print_map_info(outsider);
+    print_map_info(drawn, int(memory.size() - drawn.size()));
     
     // start drawing map
     for (int y_index = (int)grid_map[0].size() - 1; y_index >= 0; --y_index) {
         draw_y_label(y_index);
         for (int x_index = 0; x_index < get_size(); ++x_index)
-            cout << grid_map[x_index][y_index];
-        cout << endl;
+            out << grid_map[x_index][y_index];
+        out << endl;
     }
     
     // draw x label
     for (int x_index = 0; x_index < get_size(); x_index += 3) {
-        cout << "  ";
+        out << "  ";
         print_label(x_index, "x");
     }
-    cout << endl;
+    out << endl;
 }
 
 // save view status to os
@@ -101,9 +140,29 @@ bool Grid_view::get_subscripts(int &ix, int &iy, Point location) const
         return true;
 }
 
+/* The viewport of a plain map is the grid itself, padded by a cell on every side
+ so that rounding in get_subscripts can never put a drawn object outside of it. */
+void Grid_view::get_viewport(Point& lower_left, Point& upper_right) const {
+    lower_left = Point(origin.x - scale, origin.y - scale);
+    upper_right = Point(origin.x + (size + 1) * scale, origin.y + (size + 1) * scale);
+}
+
+// return in name order the objects that are not in drawn (which is sorted)
+vector<string> Grid_view::get_outsider_names(const vector<string>& drawn) const {
+    vector<string> outsider;
+    auto drawn_iter = drawn.begin();
+    for (const auto& object : memory) {
+        if (drawn_iter != drawn.end() && *drawn_iter == object.first)
+            ++drawn_iter;
+        else
+            outsider.push_back(object.first);
+    }
+    return outsider;
+}
+
 // Print size, scale, and origin
-void Grid_view::print_map_info(vector<string> outsider) const {
-    cout << "Display size: " << size << ", scale: " << scale
+void Grid_view::print_map_info(const vector<string>& drawn, int outsider_count) const {
+    out << "Display size: " << size << ", scale: " << scale
     << ", origin: " << origin << endl;
 }
 
@@ -129,22 +188,18 @@ void Grid_view::set_origin(Point origin_) {
 void Grid_view::draw_y_label(int y_index) const {
     if (y_index % 3 == 0) {
         print_label(y_index, "y");
-        cout << " ";
+        out << " ";
     } else {
-        cout << "     ";
+        out << "     ";
     }
 }
 
-// Change output stream setting and print out the label value.
+// Print out the label value, as a whole number four characters wide.
 void Grid_view::print_label(int index , const string& axis) const {
     double label_value = index * scale;
     if (axis == "x")
         label_value += origin.x;
     else if (axis == "y")
         label_value += origin.y;
-    auto old_settings = cout.flags();
-    auto old_precision = cout.precision();
-    cout << std::fixed << setprecision(0) << setw(4) << label_value;
-    cout.flags(old_settings);
-    cout.precision(old_precision);
+    out << field_width(4) << fixed_point(label_value, 0);
 }
\ No newline at end of file
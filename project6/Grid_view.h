@@ -2,17 +2,20 @@
 #define GRID_VIEW_H
 
 #include "View.h"
+#include "Spatial_grid.h"
 #include <map>
 #include <vector>
 #include <string>
 
-struct Point;
 
 class Grid_view : public View {
 public:
     // Save the supplied name and location for future use in a draw() call
     void update_location(const std::string& name, Point location) override;
     
+    // Save the locations of many objects at once
+    void update_states(const std::vector<Object_state>& states) override;
+    
     // Remove the name and its location; no error if the name is not present.
     void update_remove(const std::string& name) override;
     
@@ -24,6 +27,9 @@ public:
 protected:
     Grid_view(int size_, double scale_, Point origin_);
     Grid_view(std::istream &);
+    // the index points into memory, so a copy has to rebuild its own index
+    Grid_view(const Grid_view& other);
+    Grid_view& operator= (const Grid_view& other) = delete;
     
     /* Getter and Setter */
     int get_size() const { return size; }
@@ -38,8 +44,13 @@ protected:
     /* Helper Function */
     bool get_subscripts(int &ix, int &iy, Point location) const;
     virtual std::vector<std::vector<std::string>> get_initial_map() const = 0;
-    virtual void print_map_info(std::vector<std::string> outsider) const = 0;
+    virtual void print_map_info(const std::vector<std::string>& drawn,
+                                int outsider_count) const = 0;
     virtual Point get_relative_location(Point location) const = 0;
+    // the region, in world coordinates, that holds every object the map could show
+    virtual void get_viewport(Point& lower_left, Point& upper_right) const;
+    // return in name order the objects that are not in drawn (which is sorted)
+    std::vector<std::string> get_outsider_names(const std::vector<std::string>& drawn) const;
     virtual void update_map(std::vector<std::vector<std::string>>& grid_map,
                             int ix, int iy, const std::string& name) const;
     virtual void draw_y_label(int y_index) const;
@@ -49,6 +60,7 @@ private:
     double scale;		// distance per cell of the display
     Point origin;		// coordinates of the lower-left-hand corner
     std::map<std::string, Point> memory;
+    Spatial_grid<const std::string*> index;  // keys of memory, by location
 };
 
 #endif
\ No newline at end of file
@@ -1,23 +1,30 @@
 #include "Group.h"
 #include "Utility.h"
 #include "Geometry.h"
+#include "Output.h"
 
 #include <memory>
 #include <algorithm>
 #include <iostream>
 #include <functional>
+#include <vector>
 
 using std::shared_ptr;
 using std::for_each;
 using std::mem_fn;
 using std::find;
-using std::cout;
 using std::endl;
 using std::function;
 using std::bind;
 using namespace std::placeholders;
 
 /*********************** General Functions *********************************/
+/* A group with its members already chosen; if report_errors_ is true, a member that
+ fails a command reports it and the others still carry it out. */
+Group::Group(std::string name_, const std::vector<shared_ptr<Commandable>>& members_,
+             bool report_errors_) :
+members(members_.begin(), members_.end()), name(name_), report_errors(report_errors_) {}
+
 void Group::add_member(shared_ptr<Commandable> new_member) {
     for (auto& member : members) {
         if (!member.expired() && member.lock() == new_member) {
@@ -25,14 +32,14 @@ void Group::add_member(shared_ptr<Commandable> new_member) {
         }
     }
     members.push_back(new_member);
-    cout << "Member has been added to " << name << endl;
+    out << "Member has been added to " << name << endl;
 }
 
 void Group::delete_member(std::shared_ptr<Commandable> member) {
     for (auto iter = members.begin(); iter != members.end(); ++iter) {
         if (iter->lock() == member) {
             members.erase(iter);
-            cout << "Member has been removed from " << name << endl;
+            out << "Member has been removed from " << name << endl;
             return;
         }
     }
@@ -98,6 +105,26 @@ void Group::stop_attack() {
     control_members(mem_fn(&Commandable::stop_attack));
 }
 
+// All members take a side
+void Group::set_side(const std::string& side) {
+    control_members(bind(&Commandable::set_side, _1, side));
+}
+
+// All members patrol within radius
+void Group::patrol(double radius) {
+    control_members(bind(&Commandable::patrol, _1, radius));
+}
+
+// queue the orders for all members
+void Group::queue_orders(const std::vector<Order>& orders) {
+    control_members(bind(&Commandable::queue_orders, _1, std::cref(orders)));
+}
+
+// All members discard their orders
+void Group::clear_orders() {
+    control_members(mem_fn(&Commandable::clear_orders));
+}
+
 /* For all members in the group, first check whether that member still exists.
  if so, let that member execute the command. Otherwise, remove that memeber
  from the group */
@@ -111,6 +138,13 @@ void Group::control_members(function<void (shared_ptr<Commandable>)> control_fun
             } else {
                 members.erase(iter++);
             }
-        } catch (const Not_have_ability& e) { ++iter; }
+        } catch (const Not_have_ability& e) {
+            ++iter;
+        } catch (const Error& e) {
+            if (!report_errors)
+                throw;
+            out << e.what() << endl;
+            ++iter;
+        }
     }
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <list>
+#include <vector>
 #include <string>
 #include <functional>
 
@@ -19,6 +20,12 @@ public:
     
     Group(std::string name_):name(name_){}
     
+    /* A group with its members already chosen. If report_errors_ is true, as for a group
+     made up for one command, a member that fails a command reports it and the others
+     still carry it out; otherwise the error ends the command, as for any group. */
+    Group(std::string name_, const std::vector<std::shared_ptr<Commandable>>& members_,
+          bool report_errors_ = false);
+    
     std::string get_name() const { return name; }
     
     void add_member(std::shared_ptr<Commandable> member);
@@ -64,12 +71,26 @@ public:
     ability, we just skip that ship */
     void stop_attack() override;
     
+    // set the side of all members
+    void set_side(const std::string& side) override;
+    
+    /* All members patrol within radius. If a ship in the group does not have that
+     ability, we just skip that ship */
+    void patrol(double radius) override;
+    
+    // queue the orders for all members
+    void queue_orders(const std::vector<Order>& orders) override;
+    
+    // All members discard their orders
+    void clear_orders() override;
+    
     void control_members(std::function<void(std::shared_ptr<Commandable>)> control_func);
     
 
 private:
     std::list<std::weak_ptr<Commandable>> members;
     std::string name;
+    bool report_errors = false;     // go on to the other members when one fails?
 };
 
 #endif
\ No newline at end of file
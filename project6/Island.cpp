@@ -1,10 +1,12 @@
 #include "Island.h"
 #include "Model.h"
 #include "Utility.h"
+#include "View.h"
+#include "Output.h"
+#include "Log.h"
 
 #include <iostream>
 
-using std::cout;
 using std::endl;
 
 Island::Island (const std::string& name_, Point position_,
@@ -22,19 +24,30 @@ Island::Island(std::istream& is): Sim_object(is){
 void Island::update() {
     if (production_rate > 0) {
         fuel += production_rate * 1.0;
-        cout << "Island " << get_name() << " now has " << fuel << " tons" << endl;
+        Model::get_instance().notify_island_fuel(get_name(), fuel);
+        SIM_LOG(detail, fuel) << "Island " << get_name() << " now has " << fuel << " tons" << endl;
     }
 }
 
 // output information about the current state
 void Island::describe() const {
-    cout << "\nIsland " << get_name() << " at position " << position << endl;
-    cout << "Fuel available: " << fuel << " tons" << endl;
+    out << "\nIsland " << get_name() << " at position " << position << endl;
+    out << "Fuel available: " << fuel << " tons" << endl;
 }
 
 // ask model to notify views of current state
 void Island::broadcast_current_state() const {
     Model::get_instance().notify_location(get_name(), position);
+    Model::get_instance().notify_island_fuel(get_name(), fuel);
+}
+
+// an island only reports its location and fuel
+Object_state Island::get_current_state() const {
+    Object_state state;
+    state.name = get_name();
+    state.location = position;
+    state.fuel = fuel;
+    return state;
 }
 
 
@@ -43,7 +56,8 @@ void Island::broadcast_current_state() const {
 double Island::provide_fuel(double request) {
     double provide = request < fuel ? request : fuel;
     fuel -= provide;
-    cout << "Island " << get_name() << " supplied "
+    Model::get_instance().notify_island_fuel(get_name(), fuel);
+    SIM_LOG(detail, fuel) << "Island " << get_name() << " supplied "
          << provide << " tons of fuel" << endl;
     return provide;
 }
@@ -52,7 +66,8 @@ double Island::provide_fuel(double request) {
  and output the total as the amount the Island now has. */
 void Island::accept_fuel(double amount) {
     fuel += amount;
-    cout << "Island " << get_name() << " now has " << fuel << " tons" << endl;
+    Model::get_instance().notify_island_fuel(get_name(), fuel);
+    SIM_LOG(detail, fuel) << "Island " << get_name() << " now has " << fuel << " tons" << endl;
 }
 
 void Island::save(std::ostream & os) const {
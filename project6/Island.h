@@ -28,6 +28,7 @@ public:
 
 	// ask model to notify views of current state
 	void broadcast_current_state() const override;
+	Object_state get_current_state() const override;
 
 	// Return whichever is less, the request or the amount left,
 	// update the amount on hand accordingly, and output the amount supplied.
@@ -36,6 +37,9 @@ public:
 	// Add the amount to the amount on hand, and output the total as the amount the Island now has.
 	void accept_fuel(double amount);
 	
+	double get_fuel() const
+		{return fuel;}
+	
     void save(std::ostream&) const override;
 private:
 	Point position;				// Location of this island
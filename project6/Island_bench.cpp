@@ -0,0 +1,127 @@
+/*
+Benchmark for the Island_index distance matrix against computing the distances again.
+
+For each number of islands, the same random islands are indexed twice, once with the
+distance matrix and once without it, as Island_index does past its cutoff. Both are
+timed building the index, planning a greedy cruise itinerary, and one pass of 2-opt
+over it, which looks up every pair of distances; the tour is the same for both, so
+the difference is only that of the lookups.
+
+Usage: island_bench [output_file [max_islands]]
+The results are printed as a table and written to output_file (island_bench.json by
+default) as JSON, in the same form as those of geometry_bench.
+*/
+
+#include "Island_index.h"
+#include "Island.h"
+#include "Cruise_itinerary.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+using std::vector;
+using std::string;
+using std::shared_ptr;
+using std::cout;
+using std::endl;
+
+const int island_counts_c[] = {1000, 2000, 4000, 10000};
+const double world_size_c = 1000.;
+
+struct Result {
+	string name;
+	int islands;
+	string distances;
+	double ms;
+};
+
+// return n islands scattered over the world, in name order
+vector<shared_ptr<Island>> make_islands(int n)
+{
+	std::mt19937 generator(n);
+	std::uniform_real_distribution<double> coordinate(0., world_size_c);
+	vector<shared_ptr<Island>> islands;
+	for (int i = 0; i < n; ++i) {
+		// the same number of digits in every name keeps them in number order
+		string name = std::to_string(1000000 + i);
+		name[0] = 'I';
+		islands.push_back(std::make_shared<Island>(name, Point(coordinate(generator), coordinate(generator)), 0., 0.));
+	}
+	return islands;
+}
+
+// return how long func takes, in milliseconds
+template <typename F>
+double time_ms(F func)
+{
+	auto start = std::chrono::steady_clock::now();
+	func();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// time building an index of the islands and planning a cruise with it
+void run_index(vector<Result>& results, const vector<shared_ptr<Island>>& islands,
+			   int max_matrix_islands, const string& distances)
+{
+	int n = int(islands.size());
+	std::unique_ptr<Island_index> index;
+	results.push_back({"build index", n, distances, time_ms([&] {
+		index.reset(new Island_index(islands, max_matrix_islands));
+	})});
+	Cruise_itinerary itinerary;
+	results.push_back({"greedy itinerary", n, distances, time_ms([&] {
+		itinerary = plan_greedy_itinerary(*index, 0);
+	})});
+	results.push_back({"one 2-opt pass", n, distances, time_ms([&] {
+		improve_with_two_opt(itinerary, *index, 1);
+	})});
+}
+
+int main(int argc, char* argv[])
+{
+	string output_file = argc > 1 ? argv[1] : "island_bench.json";
+	int max_islands = argc > 2 ? std::atoi(argv[2]) : 10000;
+	if (max_islands <= 0) {
+		std::cerr << "Number of islands must be positive" << endl;
+		return 1;
+	}
+
+	vector<Result> results;
+	for (int n : island_counts_c) {
+		if (n > max_islands)
+			break;
+		vector<shared_ptr<Island>> islands = make_islands(n);
+		run_index(results, islands, n, "matrix");
+		run_index(results, islands, 0, "computed");
+	}
+
+	cout << std::left << std::setw(20) << "benchmark" << std::right << std::setw(10) << "islands"
+		 << std::setw(12) << "distances" << std::setw(12) << "ms" << endl;
+	cout << std::fixed << std::setprecision(2);
+	for (const auto& r : results)
+		cout << std::left << std::setw(20) << r.name << std::right << std::setw(10) << r.islands
+			 << std::setw(12) << r.distances << std::setw(12) << r.ms << endl;
+
+	std::ofstream os(output_file);
+	if (!os) {
+		std::cerr << "Cannot open " << output_file << endl;
+		return 1;
+	}
+	os << std::setprecision(6) << "{\n  \"benchmarks\": [\n";
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		const Result& r = results[i];
+		os << "    {\"name\": \"" << r.name << "\", \"islands\": " << r.islands
+		   << ", \"distances\": \"" << r.distances << "\", \"ms\": " << r.ms << "}"
+		   << (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	os << "  ]\n}\n";
+	return 0;
+}
@@ -0,0 +1,199 @@
+#include "Island_index.h"
+#include "Island.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+using std::vector;
+using std::shared_ptr;
+using std::pair;
+using std::max;
+
+Island_index::Island_index(const vector<shared_ptr<Island>>& islands_, int max_matrix_islands) :
+    islands(islands_) {
+    int n = size();
+    locations.reserve(n);
+    for (int id = 0; id < n; ++id) {
+        locations.push_back(islands[id]->get_location());
+        ids[islands[id].get()] = id;
+    }
+    vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    nodes.reserve(n);
+    root = build(order.begin(), order.end());
+
+    // the matrix grows with the square of the islands, so a large world goes without it
+    if (n > max_matrix_islands)
+        return;
+    distances.reserve(std::size_t(n) * (n - 1) / 2);
+    for (int i = 1; i < n; ++i)
+        for (int j = 0; j < i; ++j)
+            distances.push_back(cartesian_distance(locations[i], locations[j]));
+}
+
+// return the island with an ID, or nullptr for an ID of -1
+shared_ptr<Island> Island_index::get_island(int id) const {
+    return id < 0 ? nullptr : islands[id];
+}
+
+// return the ID of an island in the index, or -1 if it is not
+int Island_index::get_id(const shared_ptr<Island>& island) const {
+    auto iter = ids.find(island.get());
+    return iter == ids.end() ? -1 : iter->second;
+}
+
+// the distance between two islands, from the distance matrix if there is one
+double Island_index::distance(int id1, int id2) const {
+    if (id1 == id2)
+        return 0.;
+    if (distances.empty())
+        return cartesian_distance(locations[id1], locations[id2]);
+    if (id1 < id2)
+        std::swap(id1, id2);
+    return distances[std::size_t(id1) * (id1 - 1) / 2 + id2];
+}
+
+/* Return the ID of the island in candidates nearest to p, or -1 if it is empty.
+ When few candidates are left it is cheaper to look at each of them than to
+ search the tree past all the islands that are not candidates. */
+int Island_index::nearest_of(Point p, const Island_set& candidates) const {
+    if (candidates.size() * 8 > size())
+        return nearest(p, 0., [&candidates](int id) { return candidates.contains(id); });
+    int best_id = -1;
+    double best_distance = 0.;
+    candidates.for_each([this, p, &best_id, &best_distance](int id) {
+        double distance = cartesian_distance(p, locations[id]);
+        if (closer(distance, id, best_distance, best_id)) {
+            best_id = id;
+            best_distance = distance;
+        }
+    });
+    return best_id;
+}
+
+// Return the IDs of the k islands nearest to p, nearest first.
+vector<int> Island_index::k_nearest(Point p, int k) const {
+    vector<pair<double, int>> heap;
+    if (root >= 0 && k > 0)
+        k_nearest_in(root, p, k, heap);
+    std::sort_heap(heap.begin(), heap.end());
+    vector<int> result;
+    for (const auto& entry : heap)
+        result.push_back(entry.second);
+    return result;
+}
+
+// Return the ID of the island farthest from p, or -1 if there are no islands.
+int Island_index::farthest(Point p) const {
+    int best_id = -1;
+    double best_distance = 0.;
+    if (root >= 0)
+        farthest_in(root, p, best_id, best_distance);
+    return best_id;
+}
+
+// Return the IDs of the islands no farther than radius from p, in ID order.
+vector<int> Island_index::within(Point p, double radius) const {
+    vector<int> result;
+    if (root >= 0)
+        within_in(root, p, radius, result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/* Build the subtree for the IDs in [first, last) and return its node index.
+ The IDs are split at the median along the axis over which they are more spread out. */
+int Island_index::build(vector<int>::iterator first, vector<int>::iterator last) {
+    if (first == last)
+        return -1;
+    Point lower_left = locations[*first], upper_right = locations[*first];
+    for (auto iter = first; iter != last; ++iter) {
+        Point location = locations[*iter];
+        lower_left = Point(std::min(lower_left.x, location.x), std::min(lower_left.y, location.y));
+        upper_right = Point(max(upper_right.x, location.x), max(upper_right.y, location.y));
+    }
+    bool split_x = upper_right.x - lower_left.x >= upper_right.y - lower_left.y;
+    auto middle = first + (last - first) / 2;
+    std::nth_element(first, middle, last, [this, split_x](int a, int b) {
+        return split_x ? locations[a].x < locations[b].x : locations[a].y < locations[b].y;
+    });
+    int node_index = int(nodes.size());
+    nodes.push_back(Node{*middle, -1, -1, lower_left, upper_right});
+    int left = build(first, middle);
+    int right = build(middle + 1, last);
+    nodes[node_index].left = left;
+    nodes[node_index].right = right;
+    return node_index;
+}
+
+// the least distance from p to any point of the node's box
+double Island_index::min_distance_to(const Node& node, Point p) const {
+    Point nearest(max(node.lower_left.x, std::min(p.x, node.upper_right.x)),
+                  max(node.lower_left.y, std::min(p.y, node.upper_right.y)));
+    return cartesian_distance(p, nearest);
+}
+
+// the greatest distance from p to any point of the node's box
+double Island_index::max_distance_to(const Node& node, Point p) const {
+    double dx = max(std::fabs(node.lower_left.x - p.x), std::fabs(node.upper_right.x - p.x));
+    double dy = max(std::fabs(node.lower_left.y - p.y), std::fabs(node.upper_right.y - p.y));
+    return cartesian_distance(p, Point(p.x + dx, p.y + dy));
+}
+
+// keep the k nearest in a max-heap of (distance, id), so the worst one is on top
+void Island_index::k_nearest_in(int node_index, Point p, int k,
+                                vector<pair<double, int>>& heap) const {
+    const Node& node = nodes[node_index];
+    if (int(heap.size()) == k && min_distance_to(node, p) > heap.front().first)
+        return;
+    pair<double, int> entry(cartesian_distance(p, locations[node.id]), node.id);
+    if (int(heap.size()) < k) {
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end());
+    } else if (entry < heap.front()) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = entry;
+        std::push_heap(heap.begin(), heap.end());
+    }
+    int first = node.left, second = node.right;
+    if (first >= 0 && second >= 0 &&
+        min_distance_to(nodes[second], p) < min_distance_to(nodes[first], p))
+        std::swap(first, second);
+    if (first >= 0)
+        k_nearest_in(first, p, k, heap);
+    if (second >= 0)
+        k_nearest_in(second, p, k, heap);
+}
+
+void Island_index::farthest_in(int node_index, Point p, int& best_id, double& best_distance) const {
+    const Node& node = nodes[node_index];
+    if (best_id >= 0 && max_distance_to(node, p) < best_distance)
+        return;
+    double distance = cartesian_distance(p, locations[node.id]);
+    if (best_id < 0 || distance > best_distance || (distance == best_distance && node.id < best_id)) {
+        best_id = node.id;
+        best_distance = distance;
+    }
+    // search the farther child first
+    int first = node.left, second = node.right;
+    if (first >= 0 && second >= 0 &&
+        max_distance_to(nodes[second], p) > max_distance_to(nodes[first], p))
+        std::swap(first, second);
+    if (first >= 0)
+        farthest_in(first, p, best_id, best_distance);
+    if (second >= 0)
+        farthest_in(second, p, best_id, best_distance);
+}
+
+void Island_index::within_in(int node_index, Point p, double radius, vector<int>& result) const {
+    const Node& node = nodes[node_index];
+    if (min_distance_to(node, p) > radius)
+        return;
+    if (cartesian_distance(p, locations[node.id]) <= radius)
+        result.push_back(node.id);
+    if (node.left >= 0)
+        within_in(node.left, p, radius, result);
+    if (node.right >= 0)
+        within_in(node.right, p, radius, result);
+}
@@ -0,0 +1,91 @@
+#ifndef ISLAND_SET_H
+#define ISLAND_SET_H
+
+#include <vector>
+#include <cstdint>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/* Island_set is a set of islands given by their ID in the Island_index, kept as
+ one bit per island. A set of every island in a chart of thousands takes a few
+ hundred bytes, and going through the members skips 64 non-members at a time.
+ */
+
+class Island_set {
+public:
+    Island_set() = default;
+    // an empty set for IDs from 0 up to capacity
+    explicit Island_set(int capacity) : words((capacity + 63) / 64, 0) {}
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    bool contains(int id) const
+        { return (words[id / 64] >> (id % 64)) & 1; }
+
+    void insert(int id)
+    {
+        std::uint64_t bit = std::uint64_t(1) << (id % 64);
+        if (!(words[id / 64] & bit)) {
+            words[id / 64] |= bit;
+            ++count;
+        }
+    }
+
+    void erase(int id)
+    {
+        std::uint64_t bit = std::uint64_t(1) << (id % 64);
+        if (words[id / 64] & bit) {
+            words[id / 64] &= ~bit;
+            --count;
+        }
+    }
+
+    // remove all the members and the capacity
+    void clear() { words.clear(); count = 0; }
+
+    // call func(id) for each member, in increasing ID order
+    template <typename F>
+    void for_each(F func) const;
+
+private:
+    std::vector<std::uint64_t> words;
+    int count = 0;
+
+    // the position of the lowest bit set in a word that is not 0
+    static int lowest_bit(std::uint64_t word);
+};
+
+template <typename F>
+void Island_set::for_each(F func) const {
+    for (std::size_t w = 0; w < words.size(); ++w) {
+        for (std::uint64_t word = words[w]; word; word &= word - 1)
+            func(int(w * 64) + lowest_bit(word));
+    }
+}
+
+/* This is std::countr_zero in C++20. The compilers that have an instruction for it
+ are asked for it; otherwise the lowest bit alone, times a de Bruijn sequence, has a
+ different number in its top six bits for each position. */
+inline int Island_set::lowest_bit(std::uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return int(index);
+#else
+    static const int positions[64] = {
+        0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+    };
+    const std::uint64_t de_bruijn = 0x03f79d71b4cb0a89;
+    return positions[((word & (~word + 1)) * de_bruijn) >> 58];
+#endif
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include "Log.h"
+#include "Model.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+using std::string;
+
+namespace {
+
+const std::pair<std::string_view, Log_category> category_names_c[] = {
+    {"movement", Log_category::movement},
+    {"combat", Log_category::combat},
+    {"fuel", Log_category::fuel},
+    {"cargo", Log_category::cargo}
+};
+
+std::ofstream log_file;
+// the text of the event being written, while the log goes to the file
+Output record_text(nullptr);
+
+// write a number to the file as it is in memory
+template <typename T>
+void write_binary(T value) {
+    log_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+bool Log::is_category(std::string_view name) {
+    return std::any_of(std::begin(category_names_c), std::end(category_names_c),
+                       [name](const auto& category_name) { return category_name.first == name; });
+}
+
+// return the category with that name; throw Error("Unknown log category!") if none
+Log_category Log::get_category(std::string_view name) {
+    for (const auto& category_name : category_names_c)
+        if (category_name.first == name)
+            return category_name.second;
+    throw Error("Unknown log category!");
+}
+
+void Log::open_file(const string& file_name) {
+    close_file();
+    log_file.open(file_name, std::ios::binary);
+    if (!log_file)
+        throw Error("Cannot open file");
+}
+
+void Log::close_file() {
+    if (log_file.is_open())
+        log_file.close();
+    log_file.clear();
+}
+
+bool Log::is_file_open() {
+    return log_file.is_open();
+}
+
+Log_event::Log_event(Log_level level_, Log_category category_) :
+text(log_file.is_open() ? record_text : out), level(level_), category(category_) {}
+
+// an event for the file is written as a record, once all of its text is there
+Log_event::~Log_event() {
+    if (&text != &record_text)
+        return;
+    std::string_view event = record_text.get_text();
+    if (!event.empty() && event.back() == '\n')
+        event.remove_suffix(1);
+    std::uint16_t length = std::uint16_t(std::min<std::size_t>(event.size(), UINT16_MAX));
+    write_binary(std::int32_t(Model::get_instance().get_time()));
+    write_binary(std::uint8_t(level));
+    write_binary(std::uint8_t(category));
+    write_binary(length);
+    log_file.write(event.data(), length);
+    record_text.clear();
+}
@@ -0,0 +1,108 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include "Output.h"
+
+#include <string>
+#include <string_view>
+
+/* The simulation log is what the ships and islands report as their state changes:
+ that a ship will sail, is now at a place, fires, or that an island supplied fuel.
+ Each event has a level and a category, and is written with SIM_LOG, like this:
+
+     SIM_LOG(detail, movement) << get_name() << " now at " << get_location() << endl;
+
+ The levels are notice, for what happens seldom and matters, such as a ship sunk;
+ info, for what a ship says it will do when it is given a command; and detail, for
+ what happens on every update. Building with SIM_LOG_LEVEL set to the number of a
+ level, counting notice as 0, leaves out the levels after it, and the events written
+ at them are compiled to nothing. The categories, movement, combat, fuel and cargo,
+ are turned on and off while the program runs; an event in a category that is off
+ costs one test, and the values in it are not even computed. By default everything
+ is logged.
+
+ The log goes to the output, unless a log file is open, in which case it goes to the
+ file instead as binary records, one for each event, in the machine's byte order:
+     int32 time, uint8 level, uint8 category, uint16 length, then length characters
+ of text, without the newline at the end.
+ */
+
+enum class Log_level {notice, info, detail};
+
+enum class Log_category : unsigned {
+    movement = 1 << 0,
+    combat = 1 << 1,
+    fuel = 1 << 2,
+    cargo = 1 << 3
+};
+
+const unsigned all_log_categories_c = (1 << 4) - 1;
+
+#ifndef SIM_LOG_LEVEL
+#define SIM_LOG_LEVEL 2
+#endif
+
+// the most detailed level that is built in
+constexpr Log_level max_log_level_c = Log_level(SIM_LOG_LEVEL);
+
+class Log {
+public:
+    // is the level built in at all?
+    static constexpr bool is_built(Log_level level)
+    { return level <= max_log_level_c; }
+
+    // is the category turned on?
+    static bool is_on(Log_category category)
+    { return (categories & unsigned(category)) != 0; }
+
+    // turn on the categories in the mask, and turn the rest off
+    static void set_categories(unsigned mask)
+    { categories = mask; }
+
+    // is there a category with that name?
+    static bool is_category(std::string_view name);
+    // return the category with that name; throw Error("Unknown log category!") if none
+    static Log_category get_category(std::string_view name);
+
+    // send the log to a file from now on, instead of the output;
+    // may throw Error("Cannot open file")
+    static void open_file(const std::string& file_name);
+    // close the file, and send the log to the output again
+    static void close_file();
+    static bool is_file_open();
+
+private:
+    inline static unsigned categories = all_log_categories_c;
+};
+
+/* A Log_event is one event being written, from SIM_LOG to the end of the statement.
+ It is written to the output as it goes, or kept and written to the file at the end. */
+class Log_event {
+public:
+    Log_event(Log_level level_, Log_category category_);
+    ~Log_event();
+
+    Log_event(const Log_event&) = delete;
+    Log_event& operator= (const Log_event&) = delete;
+
+    template <typename T>
+    Log_event& operator<< (const T& item)
+    { text << item; return *this; }
+    Log_event& operator<< (Output& (*manipulator)(Output&))
+    { manipulator(text); return *this; }
+
+private:
+    Output& text;
+    Log_level level;
+    Log_category category;
+};
+
+/* Write a log event of a level and category, named without their enum, if the level is
+ built in and the category is on; otherwise the rest of the statement is skipped.
+ It ends in an else, so an if whose body it is needs braces. */
+#define SIM_LOG(level, category) \
+    if constexpr (!Log::is_built(Log_level::level)) {} \
+    else if (!Log::is_on(Log_category::category)) {} \
+    else Log_event(Log_level::level, Log_category::category)
+
+#endif
@@ -1,9 +1,9 @@
 #include "Map_view.h"
 #include "Utility.h"
+#include "Output.h"
 #include <iostream>
 #include <vector>
 
-using std::cout;
 using std::endl;
 using std::string;
 using std::vector;
@@ -38,13 +38,15 @@ void Map_view::set_defaults() {
 }
 
 // print out the text info before the real grid map.
-void Map_view::print_map_info(vector<string> outsider) const {
-    cout << "Display size: " << get_size() << ", scale: " << get_scale()
+void Map_view::print_map_info(const vector<string>& drawn, int outsider_count) const {
+    out << "Display size: " << get_size() << ", scale: " << get_scale()
     << ", origin: " << get_origin() << endl;
+    if (outsider_count == 0)
+        return;
+    vector<string> outsider = get_outsider_names(drawn);
     for (auto iter = outsider.begin(); iter != outsider.end(); ++iter)
-        cout << (iter != outsider.begin() ? ", " : "") << *iter;
-    if (!outsider.empty())
-        cout << " outside the map" << endl;
+        out << (iter != outsider.begin() ? ", " : "") << *iter;
+    out << " outside the map" << endl;
 }
 
 // ship's relative location does not change in Map view
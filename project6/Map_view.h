@@ -5,7 +5,6 @@
 #include <vector>
 #include <string>
 
-struct Point;
 
 class Map_view : public Grid_view {
 public:
@@ -32,7 +31,8 @@ public:
 
 private:
     /* Helper Function */
-    void print_map_info(std::vector<std::string> outsider) const override;
+    void print_map_info(const std::vector<std::string>& drawn,
+                        int outsider_count) const override;
     Point get_relative_location(Point location) const override;
     std::vector<std::vector<std::string>> get_initial_map() const override;
 };
@@ -0,0 +1,37 @@
+#include "Mapped_file.h"
+#include "Utility.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// may throw Error("Cannot open file")
+Mapped_file::Mapped_file(const std::string& file_name) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw Error("Cannot open file");
+    struct stat status;
+    if (fstat(fd, &status) < 0 || !S_ISREG(status.st_mode)) {
+        close(fd);
+        throw Error("Cannot open file");
+    }
+    size = status.st_size;
+    // an empty file cannot be mapped, and has no text anyway
+    if (size > 0) {
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            close(fd);
+            throw Error("Cannot open file");
+        }
+        madvise(address, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(address);
+    }
+    // the mapping stays valid after the file is closed
+    close(fd);
+}
+
+Mapped_file::~Mapped_file() {
+    if (data)
+        munmap(const_cast<char*>(data), size);
+}
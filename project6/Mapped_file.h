@@ -0,0 +1,27 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+
+/* A Mapped_file maps a file into memory for reading, for as long as it exists,
+ so that its text can be used in place without being read into a buffer. */
+
+class Mapped_file {
+public:
+    // may throw Error("Cannot open file")
+    explicit Mapped_file(const std::string& file_name);
+    ~Mapped_file();
+
+    Mapped_file(const Mapped_file&) = delete;
+    Mapped_file& operator= (const Mapped_file&) = delete;
+
+    std::string_view get_text() const
+    { return std::string_view(data, size); }
+
+private:
+    const char* data = nullptr;
+    std::size_t size = 0;
+};
+
+#endif
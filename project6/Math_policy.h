@@ -0,0 +1,384 @@
+#ifndef MATH_POLICY_H
+#define MATH_POLICY_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+A math policy supplies the elementary functions used by the Geometry and Navigation
+types: sqrt, sin, cos, atan2, and wrap_360, which brings an angle in degrees into [0, 360).
+The types take the policy as a template parameter, so the choice is made at compile time
+and costs nothing at run time.
+
+Exact_math calls the standard library and reproduces the results the program has
+always produced.
+
+Fast_math replaces the trigonometric functions with range reduction and short polynomials
+that the compiler can inline. The polynomials were fitted on Chebyshev nodes; the
+absolute errors against the standard library are at most:
+	sin, cos	1e-10 for |x| up to 1e5 radians
+	atan2		3e-10 radians (about 2e-8 degrees)
+	wrap_360	1e-12 degrees for |deg| up to 1e4
+sqrt is the hardware instruction in both policies and is exact.
+These are far below the two decimal places the program prints, but the last digits of
+a bearing are not the same as with Exact_math. math_policy_test checks these bounds
+and the range of wrap_360 in both policies; run it with make test.
+
+One value at a time, Fast_math is only about twice as fast as the standard library:
+each call is a chain of dependent multiplies and divides. Both policies therefore also
+have sin_cos, atan2 and wrap_360 over arrays, for batches of conversions such as the
+bulk conversions in Geometry.h and Navigation.h. Exact_math's loop over the standard
+library. Fast_math's do two values at a time with SSE2, and give exactly the same
+results as its single-value functions. Over a batch they are about 5 times as fast as
+the standard library for atan2, 7 times for sin_cos, and over 10 times for wrap_360.
+The bulk conversions gain less, as they also read and write their arrays: against
+converting one vector at a time with Exact_math, to_polar_vectors is about 6 times as
+fast, to_cartesian_vectors about 5 times, and to_compass_positions only 4.5 times.
+geometry_bench measures them all.
+
+Default_math is the policy behind Point, Cartesian_vector and the other plain names.
+It is Exact_math unless the program is built with GEOMETRY_FAST_MATH defined.
+*/
+
+struct Exact_math {
+	static double sqrt(double x)
+		{return std::sqrt(x);}
+	static double sin(double x)
+		{return std::sin(x);}
+	static double cos(double x)
+		{return std::cos(x);}
+	static double atan2(double y, double x)
+		{return std::atan2(y, x);}
+	static double wrap_360(double deg);
+
+	// sines[i] = sin(x[i]) and cosines[i] = cos(x[i]) for the n values in x
+	static void sin_cos(const double* x, double* sines, double* cosines, int n);
+	// angles[i] = atan2(y[i], x[i]) for the n values in y and x
+	static void atan2(const double* y, const double* x, double* angles, int n);
+	// wrapped[i] = wrap_360(deg[i]) for the n values in deg, which may be wrapped itself
+	static void wrap_360(const double* deg, double* wrapped, int n);
+};
+
+struct Fast_math {
+	static double sqrt(double x)
+		{return std::sqrt(x);}
+	static double sin(double x);
+	static double cos(double x);
+	static double atan2(double y, double x);
+	static double wrap_360(double deg);
+
+	// sines[i] = sin(x[i]) and cosines[i] = cos(x[i]) for the n values in x
+	static void sin_cos(const double* x, double* sines, double* cosines, int n);
+	// angles[i] = atan2(y[i], x[i]) for the n values in y and x
+	static void atan2(const double* y, const double* x, double* angles, int n);
+	// wrapped[i] = wrap_360(deg[i]) for the n values in deg, which may be wrapped itself
+	static void wrap_360(const double* deg, double* wrapped, int n);
+
+private:
+	// pi, pi/2 and pi/4, and pi/2 split in two so that k * pi_2_high is exact for the k that occur
+	static constexpr double pi = 3.14159265358979323846;
+	static constexpr double pi_2 = pi / 2.;
+	static constexpr double pi_4 = pi / 4.;
+	static constexpr double two_over_pi = 0.63661977236758134308;
+	static constexpr double pi_2_high = 1.57079632673412561417;
+	static constexpr double pi_2_low = 6.07710050650619224932e-11;
+	static constexpr double tan_pi_8 = 0.41421356237309504880;
+	// the polynomials, lowest power first: sin(r) / r and cos(r) in w = r * r for
+	// r in [-pi/4, pi/4], and atan(a) / a in w = a * a for a in [-tan(pi/8), tan(pi/8)]
+	static constexpr double sin_coefficients[] = {0.9999999999956773, -0.16666666631613367,
+		0.008333328784258024, -0.00019839202678837974, 2.717349465992818e-06};
+	static constexpr double cos_coefficients[] = {0.999999999952545, -0.4999999961514565,
+		0.04166661671587532, -0.0013886618605015964, 2.4379880315166478e-05};
+	static constexpr double atan_coefficients[] = {0.9999999993920999, -0.3333330749342966,
+		0.19998210797566446, -0.14239982918751698, 0.10572814475701643, -0.060332417014518275};
+
+	// the polynomial with coefficients c at w, by Horner's rule
+	template <int N>
+	static double polynomial(double w, const double (&c)[N]);
+	// reduce x to r in [-pi/4, pi/4] with x = r + quadrant * pi/2
+	static double reduce(double x, int& quadrant);
+	// sin of r + quadrant * pi/2, for r in [-pi/4, pi/4]
+	static double sin_in_quadrant(double r, int quadrant);
+	// condition ? if_true : if_false, with bit masks so that the compiler does not branch
+	static double select(bool condition, double if_true, double if_false);
+
+#if defined(__SSE2__)
+	// the same operations on two values at a time; a mask has all bits set where true
+	template <int N>
+	static __m128d polynomial(__m128d w, const double (&c)[N]);
+	static __m128d select(__m128d mask, __m128d if_true, __m128d if_false);
+	static __m128d floor(__m128d x);
+	static void sin_cos(__m128d x, __m128d& sines, __m128d& cosines);
+	static __m128d atan2(__m128d y, __m128d x);
+	static __m128d wrap_360(__m128d deg);
+#endif
+};
+
+#ifdef GEOMETRY_FAST_MATH
+using Default_math = Fast_math;
+#else
+using Default_math = Exact_math;
+#endif
+
+// *** Exact_math members ***
+
+// fmod leaves a negative angle negative, so it is brought up by a turn; an angle
+// just below zero would then round to 360 itself, which is 0, and adding 0 turns
+// the -0 that fmod gives for a whole number of turns back into 0
+inline double Exact_math::wrap_360(double deg)
+{
+	double wrapped = std::fmod(deg, 360.);
+	if (wrapped < 0.)
+		wrapped += 360.;
+	return wrapped >= 360. ? 0. : wrapped + 0.;
+}
+
+inline void Exact_math::sin_cos(const double* x, double* sines, double* cosines, int n)
+{
+	for (int i = 0; i < n; ++i) {
+		sines[i] = std::sin(x[i]);
+		cosines[i] = std::cos(x[i]);
+	}
+}
+
+inline void Exact_math::atan2(const double* y, const double* x, double* angles, int n)
+{
+	for (int i = 0; i < n; ++i)
+		angles[i] = std::atan2(y[i], x[i]);
+}
+
+inline void Exact_math::wrap_360(const double* deg, double* wrapped, int n)
+{
+	for (int i = 0; i < n; ++i)
+		wrapped[i] = wrap_360(deg[i]);
+}
+
+// *** Fast_math members ***
+
+template <int N>
+inline double Fast_math::polynomial(double w, const double (&c)[N])
+{
+	double p = c[N - 1];
+	for (int i = N - 2; i >= 0; --i)
+		p = c[i] + w * p;
+	return p;
+}
+
+inline double Fast_math::reduce(double x, int& quadrant)
+{
+	double k = std::floor(x * two_over_pi + 0.5);
+	quadrant = int(long(k) & 3);
+	return (x - k * pi_2_high) - k * pi_2_low;
+}
+
+inline double Fast_math::select(bool condition, double if_true, double if_false)
+{
+	std::uint64_t mask = -std::uint64_t(condition);
+	std::uint64_t true_bits, false_bits;
+	std::memcpy(&true_bits, &if_true, sizeof(double));
+	std::memcpy(&false_bits, &if_false, sizeof(double));
+	std::uint64_t bits = (true_bits & mask) | (false_bits & ~mask);
+	double result;
+	std::memcpy(&result, &bits, sizeof(double));
+	return result;
+}
+
+inline double Fast_math::sin(double x)
+{
+	int quadrant;
+	double r = reduce(x, quadrant);
+	return sin_in_quadrant(r, quadrant);
+}
+
+// cos(x) is sin(x) one quadrant on
+inline double Fast_math::cos(double x)
+{
+	int quadrant;
+	double r = reduce(x, quadrant);
+	return sin_in_quadrant(r, (quadrant + 1) & 3);
+}
+
+// The quadrant of a random angle cannot be predicted, so both polynomials are evaluated
+// and the quadrant picks one and its sign without branching.
+inline double Fast_math::sin_in_quadrant(double r, int quadrant)
+{
+	double w = r * r;
+	double value = select(quadrant & 1, polynomial(w, cos_coefficients), r * polynomial(w, sin_coefficients));
+	return select(quadrant & 2, -value, value);
+}
+
+// Which octant the point is in cannot be predicted either, so the choices are made
+// with select rather than branches.
+inline double Fast_math::atan2(double y, double x)
+{
+	double ax = std::fabs(x), ay = std::fabs(y);
+	bool wide = ax > ay;
+	double big = select(wide, ax, ay);
+	double small = select(wide, ay, ax);
+	if (big == 0.)
+		return std::atan2(y, x);	// keeps the signed zeros of the standard result
+	// atan of small / big in [0, 1], brought into [-tan(pi/8), tan(pi/8)] around pi/4
+	// if needed as (small / big - 1) / (small / big + 1), in one division
+	bool above = small > tan_pi_8 * big;
+	double a = select(above, small - big, small) / select(above, small + big, big);
+	double angle = select(above, pi_4, 0.) + a * polynomial(a * a, atan_coefficients);
+	angle = select(ay > ax, pi_2 - angle, angle);
+	angle = select(x < 0., pi - angle, angle);
+	return select(y < 0., -angle, angle);
+}
+
+// deg * (1 / 360) can round to the next whole number of turns either way, leaving
+// wrapped a little outside [0, 360), so it is brought back by a turn. Past about
+// 1e15 degrees 360 times the turns is no longer exact, and fmod is used instead.
+inline double Fast_math::wrap_360(double deg)
+{
+	if (!(std::fabs(deg) < 1e15))
+		return Exact_math::wrap_360(deg);
+	double wrapped = deg - 360. * std::floor(deg * (1. / 360.));
+	if (wrapped < 0.)
+		wrapped += 360.;
+	return wrapped >= 360. ? wrapped - 360. : wrapped;
+}
+
+inline void Fast_math::sin_cos(const double* x, double* sines, double* cosines, int n)
+{
+	int i = 0;
+#if defined(__SSE2__)
+	for (; i + 2 <= n; i += 2) {
+		__m128d s, c;
+		sin_cos(_mm_loadu_pd(x + i), s, c);
+		_mm_storeu_pd(sines + i, s);
+		_mm_storeu_pd(cosines + i, c);
+	}
+#endif
+	for (; i < n; ++i) {
+		sines[i] = sin(x[i]);
+		cosines[i] = cos(x[i]);
+	}
+}
+
+inline void Fast_math::atan2(const double* y, const double* x, double* angles, int n)
+{
+	int i = 0;
+#if defined(__SSE2__)
+	for (; i + 2 <= n; i += 2)
+		_mm_storeu_pd(angles + i, atan2(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+#endif
+	for (; i < n; ++i)
+		angles[i] = atan2(y[i], x[i]);
+}
+
+inline void Fast_math::wrap_360(const double* deg, double* wrapped, int n)
+{
+	int i = 0;
+#if defined(__SSE2__)
+	for (; i + 2 <= n; i += 2)
+		_mm_storeu_pd(wrapped + i, wrap_360(_mm_loadu_pd(deg + i)));
+#endif
+	for (; i < n; ++i)
+		wrapped[i] = wrap_360(deg[i]);
+}
+
+#if defined(__SSE2__)
+template <int N>
+inline __m128d Fast_math::polynomial(__m128d w, const double (&c)[N])
+{
+	__m128d p = _mm_set1_pd(c[N - 1]);
+	for (int i = N - 2; i >= 0; --i)
+		p = _mm_add_pd(_mm_set1_pd(c[i]), _mm_mul_pd(w, p));
+	return p;
+}
+
+inline __m128d Fast_math::select(__m128d mask, __m128d if_true, __m128d if_false)
+{
+	return _mm_or_pd(_mm_and_pd(mask, if_true), _mm_andnot_pd(mask, if_false));
+}
+
+// SSE2 has no floor; adding and subtracting 1.5 * 2^52 rounds to the nearest whole
+// number for |x| up to 2^51, which is one too many where it rounded up
+inline __m128d Fast_math::floor(__m128d x)
+{
+	const __m128d round_c = _mm_set1_pd(6755399441055744.);
+	__m128d nearest = _mm_sub_pd(_mm_add_pd(x, round_c), round_c);
+	return _mm_sub_pd(nearest, _mm_and_pd(_mm_cmpgt_pd(nearest, x), _mm_set1_pd(1.)));
+}
+
+// reduce and sin_in_quadrant for two values; the quadrant is k - 4 * floor(k / 4),
+// which is long(k) & 3 kept as a double
+inline void Fast_math::sin_cos(__m128d x, __m128d& sines, __m128d& cosines)
+{
+	__m128d k = floor(_mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(two_over_pi)), _mm_set1_pd(0.5)));
+	__m128d r = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(pi_2_high))),
+		_mm_mul_pd(k, _mm_set1_pd(pi_2_low)));
+	__m128d quadrant = _mm_sub_pd(k, _mm_mul_pd(_mm_set1_pd(4.), floor(_mm_mul_pd(k, _mm_set1_pd(0.25)))));
+	__m128d w = _mm_mul_pd(r, r);
+	__m128d sin_r = _mm_mul_pd(r, polynomial(w, sin_coefficients));
+	__m128d cos_r = polynomial(w, cos_coefficients);
+	__m128d odd = _mm_or_pd(_mm_cmpeq_pd(quadrant, _mm_set1_pd(1.)), _mm_cmpeq_pd(quadrant, _mm_set1_pd(3.)));
+	__m128d sin_negative = _mm_cmpge_pd(quadrant, _mm_set1_pd(2.));
+	__m128d cos_negative = _mm_or_pd(_mm_cmpeq_pd(quadrant, _mm_set1_pd(1.)), _mm_cmpeq_pd(quadrant, _mm_set1_pd(2.)));
+	const __m128d sign_bit = _mm_set1_pd(-0.);
+	sines = _mm_xor_pd(select(odd, cos_r, sin_r), _mm_and_pd(sin_negative, sign_bit));
+	cosines = _mm_xor_pd(select(odd, sin_r, cos_r), _mm_and_pd(cos_negative, sign_bit));
+}
+
+// A point at the origin, which is rare, is done again with std::atan2 as in the
+// single-value function.
+inline __m128d Fast_math::atan2(__m128d y, __m128d x)
+{
+	const __m128d sign_bit = _mm_set1_pd(-0.);
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d one = _mm_set1_pd(1.);
+	__m128d ax = _mm_andnot_pd(sign_bit, x), ay = _mm_andnot_pd(sign_bit, y);
+	__m128d wide = _mm_cmpgt_pd(ax, ay);
+	__m128d big = select(wide, ax, ay);
+	__m128d small = select(wide, ay, ax);
+	__m128d at_origin = _mm_cmpeq_pd(big, zero);
+	__m128d above = _mm_cmpgt_pd(small, _mm_mul_pd(_mm_set1_pd(tan_pi_8), big));
+	__m128d a = _mm_div_pd(select(above, _mm_sub_pd(small, big), small),
+		select(above, _mm_add_pd(small, big), select(at_origin, one, big)));
+	__m128d angle = _mm_add_pd(_mm_and_pd(above, _mm_set1_pd(pi_4)),
+		_mm_mul_pd(a, polynomial(_mm_mul_pd(a, a), atan_coefficients)));
+	angle = select(_mm_cmpgt_pd(ay, ax), _mm_sub_pd(_mm_set1_pd(pi_2), angle), angle);
+	angle = select(_mm_cmplt_pd(x, zero), _mm_sub_pd(_mm_set1_pd(pi), angle), angle);
+	angle = _mm_xor_pd(angle, _mm_and_pd(_mm_cmplt_pd(y, zero), sign_bit));
+	if (_mm_movemask_pd(at_origin)) {
+		double angles[2], ys[2], xs[2];
+		_mm_storeu_pd(angles, angle);
+		_mm_storeu_pd(ys, y);
+		_mm_storeu_pd(xs, x);
+		for (int i = 0; i < 2; ++i)
+			if (xs[i] == 0. && ys[i] == 0.)
+				angles[i] = std::atan2(ys[i], xs[i]);
+		angle = _mm_loadu_pd(angles);
+	}
+	return angle;
+}
+
+// An angle too large for the turns to be counted exactly, which is rare, is done
+// again with the single-value function.
+inline __m128d Fast_math::wrap_360(__m128d deg)
+{
+	const __m128d full_turn = _mm_set1_pd(360.);
+	__m128d wrapped = _mm_sub_pd(deg, _mm_mul_pd(full_turn, floor(_mm_mul_pd(deg, _mm_set1_pd(1. / 360.)))));
+	wrapped = _mm_add_pd(wrapped, _mm_and_pd(_mm_cmplt_pd(wrapped, _mm_setzero_pd()), full_turn));
+	wrapped = _mm_sub_pd(wrapped, _mm_and_pd(_mm_cmpge_pd(wrapped, full_turn), full_turn));
+	__m128d in_range = _mm_cmplt_pd(_mm_andnot_pd(_mm_set1_pd(-0.), deg), _mm_set1_pd(1e15));
+	if (_mm_movemask_pd(in_range) != 3) {
+		double degs[2], wrappeds[2];
+		_mm_storeu_pd(degs, deg);
+		_mm_storeu_pd(wrappeds, wrapped);
+		for (int i = 0; i < 2; ++i)
+			if (!(std::fabs(degs[i]) < 1e15))
+				wrappeds[i] = Exact_math::wrap_360(degs[i]);
+		wrapped = _mm_loadu_pd(wrappeds);
+	}
+	return wrapped;
+}
+#endif
+
+#endif
@@ -0,0 +1,254 @@
+/*
+Checks that Fast_math stays within the error bounds documented in Math_policy.h,
+that wrap_360 brings every angle into [0, 360) in both policies, and that the bulk
+sin_cos, atan2 and wrap_360 of both policies give exactly what their single-value functions give.
+
+Each function is compared with Exact_math on randomized inputs spread over the
+documented range, and on the inputs that are hardest for it: the ends of the
+range, the boundaries between quadrants and octants, and angles at or just either
+side of a whole number of turns. Each check is printed with the largest error found;
+the program returns 1 if any check fails.
+
+Usage: math_policy_test [samples]
+*/
+
+#include "Math_policy.h"
+
+#include <random>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using std::vector;
+using std::string;
+using std::cout;
+using std::endl;
+
+// the bounds documented in Math_policy.h
+const double sin_cos_bound_c = 1e-10;
+const double sin_cos_domain_c = 1e5;
+const double atan2_bound_c = 3e-10;
+const double wrap_360_bound_c = 1e-12;
+const double wrap_360_domain_c = 1e4;
+
+const double pi_c = 3.14159265358979323846;
+
+int failures = 0;
+
+// print the outcome of a check and count it if it failed
+void report(const string& name, double max_error, double bound)
+{
+	bool passed = max_error <= bound;
+	if (!passed)
+		++failures;
+	cout << (passed ? "pass " : "FAIL ") << std::left << std::setw(28) << name << std::right
+		 << std::scientific << std::setprecision(2) << std::setw(12) << max_error
+		 << " (bound " << bound << ")" << endl;
+}
+
+// the angles just either side of x, and x itself
+void add_neighbours(vector<double>& inputs, double x)
+{
+	inputs.push_back(std::nextafter(x, -std::numeric_limits<double>::infinity()));
+	inputs.push_back(x);
+	inputs.push_back(std::nextafter(x, std::numeric_limits<double>::infinity()));
+}
+
+// are a and b the same double, down to the sign of a zero?
+bool same_bits(double a, double b)
+{
+	return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+// the number of values for which the bulk sin_cos differs from sin and cos
+template <typename Math>
+int count_bulk_sin_cos_differences(const vector<double>& x)
+{
+	int n = int(x.size());
+	vector<double> sines(n), cosines(n);
+	Math::sin_cos(x.data(), sines.data(), cosines.data(), n);
+	int differences = 0;
+	for (int i = 0; i < n; ++i)
+		differences += !same_bits(sines[i], Math::sin(x[i])) || !same_bits(cosines[i], Math::cos(x[i]));
+	return differences;
+}
+
+// the number of points for which the bulk atan2 differs from atan2
+template <typename Math>
+int count_bulk_atan2_differences(const vector<std::pair<double, double>>& points)
+{
+	int n = int(points.size());
+	vector<double> y(n), x(n), angles(n);
+	for (int i = 0; i < n; ++i) {
+		y[i] = points[i].first;
+		x[i] = points[i].second;
+	}
+	Math::atan2(y.data(), x.data(), angles.data(), n);
+	int differences = 0;
+	for (int i = 0; i < n; ++i)
+		differences += !same_bits(angles[i], Math::atan2(y[i], x[i]));
+	return differences;
+}
+
+// the number of angles for which the bulk wrap_360 differs from wrap_360
+template <typename Math>
+int count_bulk_wrap_360_differences(const vector<double>& deg)
+{
+	int n = int(deg.size());
+	vector<double> wrapped(n);
+	Math::wrap_360(deg.data(), wrapped.data(), n);
+	int differences = 0;
+	for (int i = 0; i < n; ++i)
+		differences += !same_bits(wrapped[i], Math::wrap_360(deg[i]));
+	return differences;
+}
+
+// the difference of two angles in degrees, the short way round
+double angle_difference(double a, double b)
+{
+	double difference = std::fabs(a - b);
+	return std::min(difference, 360. - difference);
+}
+
+void check_sin_cos(std::mt19937_64& generator, int samples)
+{
+	std::uniform_real_distribution<double> angle(-sin_cos_domain_c, sin_cos_domain_c);
+	vector<double> inputs;
+	for (int i = 0; i < samples; ++i)
+		inputs.push_back(angle(generator));
+	// the quadrant boundaries, near zero and at the ends of the domain
+	for (long k = -8; k <= 8; ++k)
+		add_neighbours(inputs, k * pi_c / 4.);
+	long last_quadrant = long(sin_cos_domain_c / (pi_c / 2.));
+	for (long k = last_quadrant - 8; k <= last_quadrant; ++k) {
+		add_neighbours(inputs, k * pi_c / 2.);
+		add_neighbours(inputs, -k * pi_c / 2.);
+	}
+	add_neighbours(inputs, sin_cos_domain_c);
+	add_neighbours(inputs, -sin_cos_domain_c);
+
+	double sin_error = 0., cos_error = 0.;
+	for (double x : inputs) {
+		if (std::fabs(x) > sin_cos_domain_c)
+			continue;
+		sin_error = std::max(sin_error, std::fabs(Fast_math::sin(x) - Exact_math::sin(x)));
+		cos_error = std::max(cos_error, std::fabs(Fast_math::cos(x) - Exact_math::cos(x)));
+	}
+	report("sin", sin_error, sin_cos_bound_c);
+	report("cos", cos_error, sin_cos_bound_c);
+	report("Exact_math bulk sin_cos", count_bulk_sin_cos_differences<Exact_math>(inputs), 0.);
+	report("Fast_math bulk sin_cos", count_bulk_sin_cos_differences<Fast_math>(inputs), 0.);
+}
+
+void check_atan2(std::mt19937_64& generator, int samples)
+{
+	std::uniform_real_distribution<double> coordinate(-1e3, 1e3);
+	std::uniform_real_distribution<double> turn(-pi_c, pi_c);
+	vector<std::pair<double, double>> inputs;
+	for (int i = 0; i < samples; ++i)
+		inputs.push_back({coordinate(generator), coordinate(generator)});
+	// points on the unit circle, which cover every angle evenly
+	for (int i = 0; i < samples; ++i) {
+		double angle = turn(generator);
+		inputs.push_back({std::sin(angle), std::cos(angle)});
+	}
+	// the axes, the diagonals, and the octant boundaries at tan(pi/8)
+	const double tan_pi_8 = 0.41421356237309504880;
+	for (double y : {-1., -0., 0., 1.})
+		for (double x : {-1., -0., 0., 1.})
+			inputs.push_back({y, x});
+	for (double a : {tan_pi_8, std::nextafter(tan_pi_8, 0.), std::nextafter(tan_pi_8, 1.)})
+		for (double sign_y : {-1., 1.})
+			for (double sign_x : {-1., 1.}) {
+				inputs.push_back({sign_y * a, sign_x});
+				inputs.push_back({sign_y, sign_x * a});
+			}
+
+	double error = 0.;
+	for (const auto& input : inputs) {
+		double difference = std::fabs(Fast_math::atan2(input.first, input.second) -
+									  Exact_math::atan2(input.first, input.second));
+		// y = -0 and y = +0 on the negative x axis are -pi and pi, the same direction
+		error = std::max(error, std::min(difference, std::fabs(difference - 2. * pi_c)));
+	}
+	report("atan2", error, atan2_bound_c);
+	report("Exact_math bulk atan2", count_bulk_atan2_differences<Exact_math>(inputs), 0.);
+	report("Fast_math bulk atan2", count_bulk_atan2_differences<Fast_math>(inputs), 0.);
+}
+
+template <typename Math>
+bool wraps_into_range(double deg)
+{
+	double wrapped = Math::wrap_360(deg);
+	return wrapped >= 0. && wrapped < 360. && !std::signbit(wrapped);
+}
+
+void check_wrap_360(std::mt19937_64& generator, int samples)
+{
+	std::uniform_real_distribution<double> angle(-wrap_360_domain_c, wrap_360_domain_c);
+	vector<double> inputs;
+	for (int i = 0; i < samples; ++i)
+		inputs.push_back(angle(generator));
+	// whole numbers of turns, and the smallest and largest angles either side of zero
+	for (long k = -long(wrap_360_domain_c / 360.); k <= long(wrap_360_domain_c / 360.); ++k)
+		add_neighbours(inputs, k * 360.);
+	for (double tiny : {std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::min(), 1e-300, 1e-17})
+		for (double sign : {-1., 1.})
+			inputs.push_back(sign * tiny);
+	inputs.push_back(-0.);
+	add_neighbours(inputs, wrap_360_domain_c);
+	add_neighbours(inputs, -wrap_360_domain_c);
+
+	// the largest angles, which Fast_math wraps with fmod, in the bulk check
+	inputs.push_back(1e16);
+	inputs.push_back(-1e300);
+	double error = 0.;
+	int exact_out_of_range = 0, fast_out_of_range = 0;
+	for (double deg : inputs) {
+		if (!wraps_into_range<Exact_math>(deg))
+			++exact_out_of_range;
+		if (!wraps_into_range<Fast_math>(deg))
+			++fast_out_of_range;
+		if (std::fabs(deg) <= wrap_360_domain_c)
+			error = std::max(error, angle_difference(Fast_math::wrap_360(deg), Exact_math::wrap_360(deg)));
+	}
+	// the range holds for any finite angle, not only those in the domain
+	std::uniform_real_distribution<double> exponent(0., 300.);
+	for (int i = 0; i < samples; ++i) {
+		double deg = (i % 2 ? -1. : 1.) * std::pow(10., exponent(generator));
+		if (!wraps_into_range<Exact_math>(deg))
+			++exact_out_of_range;
+		if (!wraps_into_range<Fast_math>(deg))
+			++fast_out_of_range;
+	}
+	report("wrap_360", error, wrap_360_bound_c);
+	report("Exact_math bulk wrap_360", count_bulk_wrap_360_differences<Exact_math>(inputs), 0.);
+	report("Fast_math bulk wrap_360", count_bulk_wrap_360_differences<Fast_math>(inputs), 0.);
+	report("Exact_math wrap_360 range", exact_out_of_range, 0.);
+	report("Fast_math wrap_360 range", fast_out_of_range, 0.);
+}
+
+int main(int argc, char* argv[])
+{
+	int samples = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+	if (samples <= 0) {
+		std::cerr << "Number of samples must be positive" << endl;
+		return 1;
+	}
+	std::mt19937_64 generator(20230417);
+	check_sin_cos(generator, samples);
+	check_atan2(generator, samples);
+	check_wrap_360(generator, samples);
+	if (failures) {
+		cout << failures << " checks failed" << endl;
+		return 1;
+	}
+	cout << "All checks passed" << endl;
+	return 0;
+}
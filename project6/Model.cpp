@@ -5,17 +5,23 @@
 #include "Ship_factory.h"
 #include "Utility.h"
 #include "Group.h"
+#include "CPA_screen.h"
+#include "Cruise_itinerary.h"
+#include "Scenario.h"
+#include "Output.h"
 
 #include <type_traits>
 #include <algorithm>
 #include <iostream>
 #include <string>
 #include <map>
+#include <vector>
 #include <memory>
+#include <iterator>
+#include <limits>
 
 using std::string;
 using std::copy;
-using std::cout;
 using std::endl;
 using std::shared_ptr;
 using std::make_shared;
@@ -25,20 +31,20 @@ using namespace std::placeholders;
 
 /*************************** General Functions ****************************/
 
+// the world the simulation starts in
+const char* const initial_scenario_c = R"(
+island Exxon 10 10 1000 200
+island Shell 0 30 1000 200
+island Bermuda 20 20
+island Treasure_Island 50 5 100 5
+ship Ajax Cruiser 15 15
+ship Xerxes Cruiser 25 25
+ship Valdez Tanker 30 30
+)";
+
 // create the initial objects, output constructor message
 Model::Model() : time(0) {
-    islands.insert(make_shared<Island>("Exxon", Point(10, 10), 1000, 200));
-    islands.insert(make_shared<Island>("Shell", Point(0, 30), 1000, 200));
-    islands.insert(make_shared<Island>("Bermuda", Point(20, 20)));
-    islands.insert(make_shared<Island>("Treasure_Island", Point(50, 5), 100, 5));
-    for (auto& island : islands)
-        objects[island->get_name()] = island;
-    
-    ships.insert(create_ship("Ajax", "Cruiser", Point (15, 15)));
-    ships.insert(create_ship("Xerxes", "Cruiser", Point (25, 25)));
-    ships.insert(create_ship("Valdez", "Tanker", Point (30, 30)));
-    for (auto& ship : ships)
-        objects[ship->get_name()] = ship;
+    load_scenario(read_scenario(initial_scenario_c));
 }
 
 // get the singleton model object
@@ -66,6 +72,70 @@ bool Model::is_island_present(const string& name) const {
     return islands.find(name) != islands.end();
 }
 
+// return the itinerary shared by all cruises that start at an island,
+// planning it the first time it is asked for
+shared_ptr<const Cruise_itinerary> Model::get_cruise_itinerary(const shared_ptr<Island>& start) {
+    int start_id = island_index.get_id(start);
+    auto iter = itineraries.find(start_id);
+    if (iter != itineraries.end())
+        return iter->second;
+    auto itinerary = make_shared<Cruise_itinerary>(plan_greedy_itinerary(island_index, start_id));
+    if (two_opt_itineraries)
+        improve_with_two_opt(*itinerary, island_index);
+    itineraries[start_id] = itinerary;
+    return itinerary;
+}
+
+// plan itineraries from now on greedily, or greedily and then improved by 2-opt;
+// cruises already under way keep the itinerary they have
+void Model::set_two_opt_itineraries(bool two_opt) {
+    if (two_opt != two_opt_itineraries)
+        itineraries.clear();
+    two_opt_itineraries = two_opt;
+}
+
+// resolve hits together at the end of each update, or apply each one when it is fired
+void Model::set_batched_combat(bool batched) {
+    batched_combat = batched;
+}
+
+// record a hit to be resolved at the end of this update
+void Model::record_hit(shared_ptr<Ship> target, int firepower, shared_ptr<Ship> attacker) {
+    recorded_hits.push_back(Recorded_hit{target, attacker, firepower});
+}
+
+/* Apply the hits recorded during this update. The hits on each target are added up
+ and land as one, target by target in name order. A target that was sunk earlier in
+ the resolution takes no more hits. It reacts to the first of its attackers, in name
+ order, that is still afloat, or to the first one if all of them have been sunk, so
+ the outcome does not depend on the order in which the warships fired. It is all done
+ on this thread: receive_hit can sink a ship, which changes the Model, so the hits land
+ one target at a time, and the rest is too little work to hand to other threads. */
+void Model::resolve_combat() {
+    if (recorded_hits.empty())
+        return;
+    std::sort(recorded_hits.begin(), recorded_hits.end(),
+              [](const Recorded_hit& hit1, const Recorded_hit& hit2) {
+                  if (hit1.target != hit2.target)
+                      return hit1.target->get_name() < hit2.target->get_name();
+                  return hit1.attacker->get_name() < hit2.attacker->get_name();
+              });
+    for (auto first = recorded_hits.begin(); first != recorded_hits.end();) {
+        int damage = 0;
+        shared_ptr<Ship> attacker;
+        auto last = first;
+        for (; last != recorded_hits.end() && last->target == first->target; ++last) {
+            damage += last->firepower;
+            if (!attacker && last->attacker->is_afloat())
+                attacker = last->attacker;
+        }
+        if (first->target->is_afloat())
+            first->target->receive_hit(damage, attacker ? attacker : first->attacker);
+        first = last;
+    }
+    recorded_hits.clear();
+}
+
 // will throw Error("Island not found!") if no island of that name
 shared_ptr<Island> Model::get_island_ptr(const string& name) const {
     auto iter = islands.find(name);
@@ -83,9 +153,138 @@ bool Model::is_ship_present(const string& name) const {
 void Model::add_ship(shared_ptr<Ship> ship) {
     objects[ship->get_name()] = ship;
     ships.insert(ship);
+    ships_by_type[ship->get_type()].insert(ship);
+    ship_locations.insert(ship.get(), ship->get_location());
+    update_dead_in_water(ship.get());
     ship->broadcast_current_state();
 }
 
+/* add many new ships at once, and send the views one update for all of them.
+ The ships are in name order, so each is put in the maps right after the one before. */
+void Model::add_ships(const std::vector<shared_ptr<Ship>>& new_ships) {
+    if (new_ships.empty())
+        return;
+    const string& first_name = new_ships.front()->get_name();
+    auto object_hint = objects.lower_bound(first_name);
+    auto ship_hint = ships.lower_bound(first_name);
+    // a fleet is usually of one type
+    auto& same_type = ships_by_type[new_ships.front()->get_type()];
+    auto type_hint = same_type.lower_bound(first_name);
+    for (const auto& ship : new_ships) {
+        object_hint = std::next(objects.emplace_hint(object_hint, ship->get_name(), ship));
+        ship_hint = std::next(ships.emplace_hint(ship_hint, ship));
+        if (ship->get_type() == new_ships.front()->get_type())
+            type_hint = std::next(same_type.emplace_hint(type_hint, ship));
+        else
+            ships_by_type[ship->get_type()].insert(ship);
+        ship_locations.insert(ship.get(), ship->get_location());
+        update_dead_in_water(ship.get());
+    }
+    if (views.empty())
+        return;
+    std::vector<Object_state> states;
+    states.reserve(new_ships.size());
+    for (const auto& ship : new_ships)
+        states.push_back(ship->get_current_state());
+    for (auto& view : views)
+        view->update_states(states);
+}
+
+// return in name order the ships whose names begin with prefix
+std::vector<shared_ptr<Ship>> Model::find_ships_by_prefix(std::string_view prefix) const {
+    std::vector<shared_ptr<Ship>> found;
+    for (auto iter = ships.lower_bound(prefix);
+         iter != ships.end() && std::string_view((*iter)->get_name()).substr(0, prefix.size()) == prefix;
+         ++iter)
+        found.push_back(*iter);
+    return found;
+}
+
+// return in name order the ships of a type, such as "Cruiser"
+std::vector<shared_ptr<Ship>> Model::find_ships_by_type(std::string_view type) const {
+    auto iter = ships_by_type.find(type);
+    if (iter == ships_by_type.end())
+        return {};
+    return std::vector<shared_ptr<Ship>>(iter->second.begin(), iter->second.end());
+}
+
+// return in name order the ships no farther than radius from center
+std::vector<shared_ptr<Ship>> Model::find_ships_within(Point center, double radius) const {
+    std::vector<Ship*> found;
+    ship_locations.for_each_in_circle(center, radius, [&found](Ship* ship, Point) {
+        found.push_back(ship);
+    });
+    std::sort(found.begin(), found.end(), [](const Ship* ship1, const Ship* ship2) {
+        return ship1->get_name() < ship2->get_name();
+    });
+    std::vector<shared_ptr<Ship>> ship_ptrs;
+    ship_ptrs.reserve(found.size());
+    for (Ship* ship : found)
+        ship_ptrs.push_back(ship->shared_from_this());
+    return ship_ptrs;
+}
+
+// the ship has moved from old_location to where it is now
+void Model::ship_moved(Ship* ship, Point old_location) {
+    ship_locations.move(ship, old_location, ship->get_location());
+}
+
+// return the afloat ship hostile to ship that is nearest to it and no farther than
+// radius, or nullptr if there is none; ties go to the ship whose name comes first
+shared_ptr<Ship> Model::find_nearest_hostile(const Ship& ship, double radius) const {
+    Point p = ship.get_location();
+    Ship* nearest = nullptr;
+    double min_distance = 0.;
+    ship_locations.for_each_in_circle(p, radius, [&](Ship* other, Point location) {
+        if (!ship.is_hostile_to(*other) || !other->is_afloat())
+            return;
+        double distance = cartesian_distance(p, location);
+        if (!nearest || distance < min_distance ||
+            (distance == min_distance && other->get_name() < nearest->get_name())) {
+            nearest = other;
+            min_distance = distance;
+        }
+    });
+    return nearest ? nearest->shared_from_this() : nullptr;
+}
+
+// add the ship to, or remove it from, the ships dead in the water, according to its state
+void Model::update_dead_in_water(Ship* ship) {
+    bool dead = ship->get_state() == Ship_state::dead_in_the_water && ships.count(ship->get_name());
+    bool registered = dead_in_water_ships.count(ship) > 0;
+    if (dead == registered)
+        return;
+    if (dead) {
+        dead_in_water_ships.insert(ship);
+        refuel_dispatcher.add_ship(ship, ship->get_location());
+    } else {
+        dead_in_water_ships.erase(ship);
+        refuel_dispatcher.release_ship(ship);
+    }
+}
+
+// the refuel ship, which moves at speed, is waiting at base for a ship dead in the water
+void Model::add_waiting_refuel_ship(Ship* refuel_ship, Point base, double speed) {
+    refuel_dispatcher.add_waiting(refuel_ship, base, speed);
+}
+
+// return the ship dead in the water that the dispatcher gives to a waiting refuel ship,
+// or nullptr if there is none for it now
+shared_ptr<Ship> Model::take_refuel_assignment(Ship* refuel_ship) {
+    Ship* ship = refuel_dispatcher.take_assignment(refuel_ship);
+    return ship ? get_ship_ptr(ship->get_name()) : nullptr;
+}
+
+// the refuel ship stops waiting and gives up the ship it was going to refuel, if any
+void Model::remove_refuel_ship(Ship* refuel_ship) {
+    refuel_dispatcher.remove_refuel_ship(refuel_ship);
+}
+
+// the refuel ship, which is not waiting, is on its way to the ship, as when restored
+void Model::claim_for_refuel(Ship* refuel_ship, Ship* ship) {
+    refuel_dispatcher.claim(ship, refuel_ship);
+}
+
 // will throw Error("Ship not found!") if no ship of that name
 shared_ptr<Ship> Model::get_ship_ptr(const std::string& name) const {
     auto iter = ships.find(name);
@@ -100,11 +299,204 @@ void Model::describe() const {
         object.second->describe();
 }
 
+namespace {
+
+/* Describe the objects of two sequences in name order, the ships from one and the
+ islands from the other, that pass their tests; leave out the first offset of them and
+ stop after limit, or go on to the end if limit is -1. Return how many were described.
+ The sequences hold pointers of any kind, in name order. */
+template <typename Ship_iter, typename Island_iter, typename Ship_test, typename Island_test>
+int describe_merged(Ship_iter ship_iter, Ship_iter ships_end, Ship_test ship_test,
+                    Island_iter island_iter, Island_iter islands_end, Island_test island_test,
+                    int offset, int limit) {
+    // move each on to the next object that passes
+    auto next_ship = [&] {
+        while (ship_iter != ships_end && !ship_test(**ship_iter))
+            ++ship_iter;
+    };
+    auto next_island = [&] {
+        while (island_iter != islands_end && !island_test(**island_iter))
+            ++island_iter;
+    };
+    next_ship();
+    next_island();
+    int described = 0;
+    while ((limit < 0 || described < limit) &&
+           (ship_iter != ships_end || island_iter != islands_end)) {
+        const Sim_object* object;
+        if (island_iter == islands_end ||
+            (ship_iter != ships_end && (*ship_iter)->get_name() < (*island_iter)->get_name())) {
+            object = &**ship_iter;
+            ++ship_iter;
+            next_ship();
+        } else {
+            object = &**island_iter;
+            ++island_iter;
+            next_island();
+        }
+        if (offset > 0) {
+            --offset;
+        } else {
+            object->describe();
+            ++described;
+        }
+    }
+    return described;
+}
+
+} // namespace
+
+/* tell the objects the filter selects to describe themselves, and return how many did.
+ The ships are taken from the most selective index the filter can use: the grid of their
+ locations, the ships dead in the water, or the ships of the type. The other tests are
+ made only on the ships it gives, and the islands are looked at only if they can pass. */
+int Model::describe(const Status_filter& filter) const {
+    const std::string island_type_c = "Island";
+    bool include_islands = !filter.by_state && (filter.type.empty() || filter.type == island_type_c);
+    bool include_ships = filter.type != island_type_c;
+    
+    auto is_near = [&filter](const Sim_object& object) {
+        return cartesian_distance(object.get_location(), filter.center) <= filter.radius;
+    };
+    // the near test, if the islands do not come from the index
+    bool test_island_near = filter.near;
+    auto island_test = [&](const Island& island) {
+        return (!test_island_near || is_near(island)) &&
+               (!filter.by_fuel || island.get_fuel() < filter.fuel_below);
+    };
+    // the tests the index the ships come from has not already made
+    bool test_type = !filter.type.empty(), test_state = filter.by_state, test_near = filter.near;
+    auto ship_test = [&](const Ship& ship) {
+        return (!test_type || ship.get_type() == filter.type) &&
+               (!test_state || ship.get_state() == filter.state) &&
+               (!test_near || is_near(ship)) &&
+               (!filter.by_fuel || ship.get_fuel() < filter.fuel_below);
+    };
+    // near a point, the islands come from the index, which gives them in name order
+    std::vector<const Island*> near_islands;
+    if (include_islands && filter.near) {
+        for (int id : island_index.within(filter.center, filter.radius))
+            near_islands.push_back(island_index.get_island(id).get());
+        test_island_near = false;
+    }
+    auto describe_with_islands = [&](auto ships_begin, auto ships_end, auto test) {
+        if (include_islands && filter.near)
+            return describe_merged(ships_begin, ships_end, test,
+                                   near_islands.begin(), near_islands.end(), island_test,
+                                   filter.offset, filter.limit);
+        auto islands_begin = include_islands ? islands.begin() : islands.end();
+        return describe_merged(ships_begin, ships_end, test,
+                               islands_begin, islands.end(), island_test,
+                               filter.offset, filter.limit);
+    };
+
+    std::vector<const Ship*> found;
+    if (include_ships && filter.near) {
+        ship_locations.for_each_in_circle(filter.center, filter.radius, [&found](Ship* ship, Point) {
+            found.push_back(ship);
+        });
+        test_near = false;
+    } else if (include_ships && filter.by_state && filter.state == Ship_state::dead_in_the_water) {
+        found.assign(dead_in_water_ships.begin(), dead_in_water_ships.end());
+        test_state = false;
+    } else if (include_ships && !filter.type.empty()) {
+        auto type_iter = ships_by_type.find(filter.type);
+        if (type_iter == ships_by_type.end())
+            return 0;
+        test_type = false;
+        return describe_with_islands(type_iter->second.begin(), type_iter->second.end(), ship_test);
+    } else {
+        auto ships_begin = include_ships ? ships.begin() : ships.end();
+        return describe_with_islands(ships_begin, ships.end(), ship_test);
+    }
+    // the ships an index found are put in name order, after leaving out those that fail
+    found.erase(std::remove_if(found.begin(), found.end(),
+                               [&ship_test](const Ship* ship) { return !ship_test(*ship); }),
+                found.end());
+    std::sort(found.begin(), found.end(), [](const Ship* ship1, const Ship* ship2) {
+        return ship1->get_name() < ship2->get_name();
+    });
+    return describe_with_islands(found.begin(), found.end(), [](const Ship&) { return true; });
+}
+
 // increment the time, and tell all objects to update themselves
 void Model::update() {
     ++time;
+    run_scheduled_commands();
     for (const auto& object : objects)
         object.second->update();
+    resolve_combat();
+    if (cpa_alert)
+        print_close_approaches(cpa_alert_range, cpa_alert_time, "CPA alert: ", true);
+}
+
+/* Run a line of commands at the start of the update to a later time, and then every
+ period hours if period is positive. */
+void Model::schedule_commands(int at_time, int period, const string& commands) {
+    schedule.insert(at_time, Scheduled_commands{commands, period});
+}
+
+void Model::set_command_runner(std::function<void(const string&)> runner) {
+    command_runner = runner;
+}
+
+/* run the commands scheduled for the current time; repeating ones are scheduled again
+ first, unless the next time is past the last time there is */
+void Model::run_scheduled_commands() {
+    schedule.advance([this](Scheduled_commands& scheduled) {
+        if (scheduled.period > 0 && scheduled.period <= std::numeric_limits<int>::max() - time)
+            schedule.insert(time + scheduled.period, scheduled);
+        if (command_runner)
+            command_runner(scheduled.commands);
+    });
+}
+
+/* Find every pair of ships whose closest point of approach is within range nm
+ and time hours. Each pair is returned in name order, as indices into ships. */
+std::vector<Close_approach> Model::find_close_approaches(double range, double time) const {
+    std::vector<const Track_base*> tracks;
+    tracks.reserve(ships.size());
+    for (const auto& ship : ships)
+        tracks.push_back(&ship->get_track());
+    return screen_close_approaches(tracks, range, time);
+}
+
+// print the close approaches within range and time, or that there are none
+void Model::describe_close_approaches(double range, double time) const {
+    if (!print_close_approaches(range, time, "", false))
+        out << "No close approaches" << endl;
+}
+
+// report close approaches between moving ships at the end of every update, until cleared
+void Model::set_cpa_alert(double range, double time) {
+    cpa_alert = true;
+    cpa_alert_range = range;
+    cpa_alert_time = time;
+}
+
+void Model::clear_cpa_alert() {
+    cpa_alert = false;
+}
+
+// print the close approaches within range and time, each line begun with prefix,
+// leaving out those between ships that are not moving relative to each other if asked;
+// return whether any were printed
+bool Model::print_close_approaches(double range, double time, const char* prefix,
+                                   bool moving_only) const {
+    std::vector<Close_approach> approaches = find_close_approaches(range, time);
+    if (moving_only)
+        approaches.erase(std::remove_if(approaches.begin(), approaches.end(),
+                                        [](const Close_approach& approach) { return !approach.moving; }),
+                         approaches.end());
+    if (approaches.empty())
+        return false;
+    std::vector<shared_ptr<Ship>> ship_list(ships.begin(), ships.end());
+    for (const auto& approach : approaches) {
+        out << prefix << ship_list[approach.first]->get_name() << " and "
+             << ship_list[approach.second]->get_name() << " within " << approach.range
+             << " nm in " << approach.time << " hr" << endl;
+    }
+    return true;
 }
 
 /************************** Group Functions *******************************/
@@ -122,6 +514,17 @@ bool Model::is_group_present(const std::string& group_name) const {
     return groups.find(group_name) != groups.end();
 }
 
+// return the ship or else the group with that name, or nullptr if there is neither
+shared_ptr<Commandable> Model::find_commandable(std::string_view name) const {
+    auto ship_iter = ships.find(name);
+    if (ship_iter != ships.end())
+        return *ship_iter;
+    auto group_iter = groups.find(name);
+    if (group_iter != groups.end())
+        return group_iter->second;
+    return nullptr;
+}
+
 shared_ptr<Group> Model::get_group_ptr(const string& group_name) const {
     auto iter = groups.find(group_name);
     if (iter == groups.end())
@@ -142,11 +545,15 @@ void Model::detach_group(shared_ptr<Group> group_ptr) {
 /****************************** View Functions *****************************/
 
 /* Attaching a View adds it to the container and causes it to be updated
- with all current objects'location (or other state information. */
+ with all current objects'location (or other state information.
+ Only the new view gets the snapshot; the attached ones are already current. */
 void Model::attach(shared_ptr<View> view) {
     views.push_back(view);
+    std::vector<Object_state> snapshot;
+    snapshot.reserve(objects.size());
     for (const auto& object : objects)
-        object.second->broadcast_current_state();
+        snapshot.push_back(object.second->get_current_state());
+    view->update_states(snapshot);
 }
 
 /* Detach the View by discarding the supplied pointer from the container of Views
@@ -159,6 +566,10 @@ void Model::detach(shared_ptr<View> detach_view) {
 void Model::remove_ship(shared_ptr<Ship> ship_ptr) {
     objects.erase(ship_ptr->get_name());
     ships.erase(ship_ptr);
+    ships_by_type[ship_ptr->get_type()].erase(ship_ptr);
+    ship_locations.remove(ship_ptr.get(), ship_ptr->get_location());
+    update_dead_in_water(ship_ptr.get());
+    refuel_dispatcher.remove_refuel_ship(ship_ptr.get());
 }
 
 // notify the views about an object's location
@@ -191,6 +602,24 @@ void Model::notify_speed(const std::string& name, double speed) {
         view->update_speed(name, speed);
 }
 
+// notify the views about a ship's kind and state
+void Model::notify_ship_state(const string& name, const string& type, Ship_state state) {
+    for (auto& view : views)
+        view->update_ship_state(name, type, state);
+}
+
+// notify the views whether a ship is attacking
+void Model::notify_attacking(const string& name, bool attacking) {
+    for (auto& view : views)
+        view->update_attacking(name, attacking);
+}
+
+// notify the views about an island's fuel
+void Model::notify_island_fuel(const string& name, double fuel) {
+    for (auto& view : views)
+        view->update_island_fuel(name, fuel);
+}
+
 void Model::save(std::ostream& os) {
     os << views.size() << endl;
     std::for_each(views.begin(), views.end(), std::bind(&View::save, _1, std::ref(os)));
@@ -199,30 +628,114 @@ void Model::save(std::ostream& os) {
     std::for_each(islands.begin(), islands.end(), std::bind(&Island::save, _1, std::ref(os)));
     os << ships.size() << endl;
     std::for_each(ships.begin(), ships.end(), std::bind(&Ship::save, _1, std::ref(os)));
+    // the commands are the rest of the line
+    os << schedule.size() << endl;
+    schedule.for_each([&os](int at_time, const Scheduled_commands& scheduled) {
+        os << at_time << " " << scheduled.period << " " << scheduled.commands << endl;
+    });
 }
 
 void Model::restore(std::istream& is) {
     time = read_int(is);
+    schedule.clear(time);
     int islands_size = read_int(is);
     while (islands_size--) {
         std::shared_ptr<Island> island_ptr(new Island(is));
         islands.insert(island_ptr);
         objects[island_ptr->get_name()] = island_ptr;
     }
+    index_islands();
     int ship_size = read_int(is);
     while (ship_size--) {
         std::shared_ptr<Ship> ship_ptr = restore_ship(is);
         if (!get_instance().is_ship_present(ship_ptr->get_name())) {
             ships.insert(ship_ptr);
+            ships_by_type[ship_ptr->get_type()].insert(ship_ptr);
             objects[ship_ptr->get_name()] = ship_ptr;
         }
     }
+    // a ship named before its own record was added in its place, and then took on the
+    // record, so the ships are located and registered only once all of them are in
+    ship_locations.clear();
+    for (const auto& ship : ships) {
+        ship_locations.insert(ship.get(), ship->get_location());
+        update_dead_in_water(ship.get());
+    }
+    for (const auto& ship : ships)
+        ship->resume_after_restore();
+    int schedule_size = read_int(is);
+    while (schedule_size--) {
+        int at_time = read_int(is);
+        int period = read_int(is);
+        string commands;
+        std::getline(is >> std::ws, commands);
+        schedule.insert(at_time, Scheduled_commands{commands, period});
+    }
 }
 
 void Model::reset() {
     get_instance().time = 0;
     get_instance().objects = std::map<std::string, std::shared_ptr<Sim_object>> ();
     get_instance().islands = std::set<std::shared_ptr<Island>, Comp> ();
+    get_instance().island_index = Island_index();
+    get_instance().itineraries.clear();
     get_instance().ships =  std::set<std::shared_ptr<Ship>, Comp>();
+    get_instance().ships_by_type.clear();
+    get_instance().ship_locations.clear();
+    get_instance().dead_in_water_ships.clear();
+    get_instance().refuel_dispatcher.clear();
+    get_instance().groups.clear();
+    get_instance().two_opt_itineraries = false;
+    get_instance().cpa_alert = false;
+    get_instance().cpa_alert_range = 0.;
+    get_instance().cpa_alert_time = 0.;
+    get_instance().batched_combat = false;
+    get_instance().recorded_hits.clear();
+    get_instance().schedule.clear(0);
     get_instance().views = std::list<std::shared_ptr<View>> ();
 }
+
+/* add the islands, ships and groups of a scenario to an empty model. The islands and
+ ships come in name order, so each goes in at the end of the containers, and objects is
+ filled by merging the two; the island index is built once, after all of them. */
+void Model::load_scenario(const Scenario& scenario) {
+    groups.clear();
+    for (const auto& island : scenario.islands)
+        islands.emplace_hint(islands.end(), island);
+    for (const auto& ship : scenario.ships) {
+        ships.emplace_hint(ships.end(), ship);
+        auto& same_type = ships_by_type[ship->get_type()];
+        same_type.emplace_hint(same_type.end(), ship);
+        ship_locations.insert(ship.get(), ship->get_location());
+        update_dead_in_water(ship.get());
+    }
+    auto island_iter = scenario.islands.begin();
+    auto ship_iter = scenario.ships.begin();
+    while (island_iter != scenario.islands.end() || ship_iter != scenario.ships.end()) {
+        if (ship_iter == scenario.ships.end() ||
+            (island_iter != scenario.islands.end() &&
+             (*island_iter)->get_name() < (*ship_iter)->get_name())) {
+            objects.emplace_hint(objects.end(), (*island_iter)->get_name(), *island_iter);
+            ++island_iter;
+        }
+        else {
+            objects.emplace_hint(objects.end(), (*ship_iter)->get_name(), *ship_iter);
+            ++ship_iter;
+        }
+    }
+    index_islands();
+    
+    for (const auto& declaration : scenario.groups) {
+        std::vector<shared_ptr<Commandable>> members;
+        members.reserve(declaration.members.size());
+        for (const auto& member : declaration.members)
+            members.push_back(find_commandable(member));
+        groups.emplace(declaration.name, make_shared<Group>(declaration.name, members));
+    }
+}
+
+// rebuild the island index after islands are added; the itineraries go with it
+void Model::index_islands() {
+    island_index = Island_index(std::vector<shared_ptr<Island>>(islands.begin(), islands.end()));
+    itineraries.clear();
+}
@@ -2,13 +2,20 @@
 #define MODEL_H
 
 #include "Sim_object.h"
+#include "Island_index.h"
+#include "Spatial_grid.h"
+#include "Refuel_dispatcher.h"
+#include "Timing_wheel.h"
 
 #include <set>
 #include <map>
 #include <list>
+#include <vector>
 #include <string>
+#include <string_view>
 #include <iosfwd>
 #include <memory>
+#include <functional>
 
 /*
 Model is part of a simplified Model-View-Controller pattern.
@@ -16,7 +23,7 @@ Model keeps track of the Sim_objects in our little world. It is the only
 component that knows how many Islands and Ships there are, but it does not
 know about any of their derived classes, nor which Ships are of what kind of Ship. 
 It has facilities for looking up objects by name, and removing Ships.  When
-created, it creates an initial group of Islands and Ships using the Ship_factory.
+created, it loads an initial group of Islands and Ships from a built-in Scenario.
 Finally, it keeps the system's time.
 
 Controller tells Model what to do; Model in turn tells the objects what do, and
@@ -29,7 +36,11 @@ class Ship;
 class View;
 class Group;
 class Island;
-struct Point;
+class Commandable;
+struct Close_approach;
+struct Cruise_itinerary;
+struct Scenario;
+enum class Ship_state;
 
 struct Comp {
     using is_transparent = std::true_type;
@@ -39,6 +50,26 @@ struct Comp {
     { return object->get_name() < name; }
     bool operator() (const std::string& name, const std::shared_ptr<Sim_object> object) const
     { return name < object->get_name(); }
+    bool operator() (const std::shared_ptr<Sim_object> object, std::string_view name) const
+    { return object->get_name() < name; }
+    bool operator() (std::string_view name, const std::shared_ptr<Sim_object> object) const
+    { return name < object->get_name(); }
+};
+
+/* Which objects status describes: those that pass every test that is set, in name
+ order, leaving out the first offset of them and stopping after limit. The tests on
+ type and state pass only ships, unless the type is Island. */
+struct Status_filter {
+    std::string type;               // a kind of ship, or Island; empty for any
+    bool by_state = false;
+    Ship_state state;
+    bool near = false;              // no farther than radius from center
+    Point center;
+    double radius = 0.;
+    bool by_fuel = false;           // less fuel than fuel_below
+    double fuel_below = 0.;
+    int offset = 0;
+    int limit = -1;                 // -1 for no limit
 };
 
 class Model {
@@ -75,6 +106,17 @@ public:
     const std::set<std::shared_ptr<Island>, Comp>& get_all_islands() const
     {return islands;}
     
+    // return the index for finding islands by distance
+    const Island_index& get_island_index() const
+    {return island_index;}
+    
+    // return the itinerary shared by all cruises that start at an island,
+    // planning it the first time it is asked for
+    std::shared_ptr<const Cruise_itinerary> get_cruise_itinerary(const std::shared_ptr<Island>& start);
+    
+    // plan itineraries from now on greedily, or greedily and then improved by 2-opt
+    void set_two_opt_itineraries(bool two_opt);
+    
     // return all ship pointers.
     const std::set<std::shared_ptr<Ship>, Comp>& get_ships() const
     {return ships;}
@@ -83,14 +125,72 @@ public:
 	bool is_ship_present(const std::string& name) const;
 	// add a new ship to the list, and update the view
     void add_ship(std::shared_ptr<Ship>);
+    /* add many new ships at once, and send the views one update for all of them;
+     the ships must be in name order, and no name may be in use */
+    void add_ships(const std::vector<std::shared_ptr<Ship>>& new_ships);
 	// will throw Error("Ship not found!") if no ship of that name
     std::shared_ptr<Ship> get_ship_ptr(const std::string& name) const;
+    
+    // return in name order the ships whose names begin with prefix
+    std::vector<std::shared_ptr<Ship>> find_ships_by_prefix(std::string_view prefix) const;
+    // return in name order the ships of a type, such as "Cruiser"
+    std::vector<std::shared_ptr<Ship>> find_ships_by_type(std::string_view type) const;
+    // return in name order the ships no farther than radius from center
+    std::vector<std::shared_ptr<Ship>> find_ships_within(Point center, double radius) const;
+    
+    // the ship has moved from old_location to where it is now
+    void ship_moved(Ship* ship, Point old_location);
+    
+    // return the afloat ship hostile to ship that is nearest to it and no farther than
+    // radius, or nullptr if there is none; ties go to the ship whose name comes first
+    std::shared_ptr<Ship> find_nearest_hostile(const Ship& ship, double radius) const;
+    
+    // add the ship to, or remove it from, the ships dead in the water, according to its state
+    void update_dead_in_water(Ship* ship);
+    
+    // the refuel ship, which moves at speed, is waiting at base for a ship dead in the water
+    void add_waiting_refuel_ship(Ship* refuel_ship, Point base, double speed);
+    // return the ship dead in the water that the dispatcher gives to a waiting refuel ship,
+    // or nullptr if there is none for it now
+    std::shared_ptr<Ship> take_refuel_assignment(Ship* refuel_ship);
+    // the refuel ship stops waiting and gives up the ship it was going to refuel, if any
+    void remove_refuel_ship(Ship* refuel_ship);
+    // the refuel ship, which is not waiting, is on its way to the ship, as when restored
+    void claim_for_refuel(Ship* refuel_ship, Ship* ship);
 	
 	// tell all objects to describe themselves
 	void describe() const;
+    /* tell the objects the filter selects to describe themselves, and return how many
+     did; only the objects an index finds for the filter are looked at */
+    int describe(const Status_filter& filter) const;
 	// increment the time, and tell all objects to update themselves
 	void update();	
 	
+	/* Find every pair of ships whose closest point of approach is within range nm
+     and time hours. Each pair is returned in name order, as indices into get_ships(). */
+    std::vector<Close_approach> find_close_approaches(double range, double time) const;
+    
+    // print the close approaches within range and time, or that there are none
+    void describe_close_approaches(double range, double time) const;
+    
+    /* report close approaches at the end of every update, until cleared; ships that
+     are not moving relative to each other, such as two docked at one island, are left out */
+    void set_cpa_alert(double range, double time);
+    void clear_cpa_alert();
+    
+    /* In batched combat, warships do not hit their targets when they fire; the hits are
+     recorded and resolved together at the end of the update. Otherwise a hit lands at once. */
+    void set_batched_combat(bool batched);
+    bool is_batched_combat() const
+    {return batched_combat;}
+    // record a hit to be resolved at the end of this update
+    void record_hit(std::shared_ptr<Ship> target, int firepower, std::shared_ptr<Ship> attacker);
+    
+    /* Run a line of commands at the start of the update to a later time, and then every
+     period hours if period is positive. They are run by the function the Controller sets. */
+    void schedule_commands(int at_time, int period, const std::string& commands);
+    void set_command_runner(std::function<void(const std::string&)> runner);
+	
     
     /************************** Group Functions *******************************/
     
@@ -104,6 +204,9 @@ public:
     // get group pointer. Throw an error if no group with that name exists.
     std::shared_ptr<Group> get_group_ptr(const std::string& group_name) const;
     
+    // return the ship or else the group with that name, or nullptr if there is neither
+    std::shared_ptr<Commandable> find_commandable(std::string_view name) const;
+    
     // Attach a group to the container
     void attach_group(std::shared_ptr<Group>);
     
@@ -137,6 +240,15 @@ public:
     // notify the views about an object's speed
     void notify_speed(const std::string& name, double speed);
     
+    // notify the views about a ship's kind and state
+    void notify_ship_state(const std::string& name, const std::string& type, Ship_state state);
+    
+    // notify the views whether a ship is attacking
+    void notify_attacking(const std::string& name, bool attacking);
+    
+    // notify the views about an island's fuel
+    void notify_island_fuel(const std::string& name, double fuel);
+    
 	// notify the views that an object is now gone
 	void notify_gone(const std::string& name);
     
@@ -148,6 +260,10 @@ public:
     
     // reset the model to init state
     void reset();
+    
+    /* add the islands, ships and groups of a scenario to an empty model, such as one
+     just reset; the groups it had before are discarded */
+    void load_scenario(const Scenario& scenario);
 private:
     // create the initial objects.
     Model();
@@ -156,9 +272,49 @@ private:
 	int time;		// the simulated time
     std::map<std::string, std::shared_ptr<Sim_object>> objects;
     std::set<std::shared_ptr<Island>, Comp> islands;
+    Island_index island_index;
+    // every ship by its location, kept up to date as they move
+    Spatial_grid<Ship*> ship_locations{15.};
+    // the ships that are dead in the water; the dispatcher keeps where they are
+    std::set<const Ship*> dead_in_water_ships;
+    // pairs waiting refuel ships with ships dead in the water within 20 nm of their base
+    Refuel_dispatcher refuel_dispatcher{20.};
+    std::map<int, std::shared_ptr<const Cruise_itinerary>> itineraries;  // by start island ID
+    bool two_opt_itineraries = false;
     std::set<std::shared_ptr<Ship>, Comp> ships;
+    std::map<std::string, std::set<std::shared_ptr<Ship>, Comp>, std::less<>> ships_by_type;
     std::list<std::shared_ptr<View>> views;
-    std::map<std::string, std::shared_ptr<Group>> groups;
+    std::map<std::string, std::shared_ptr<Group>, std::less<>> groups;
+    bool cpa_alert = false;
+    double cpa_alert_range = 0.;
+    double cpa_alert_time = 0.;
+    bool batched_combat = false;
+    struct Recorded_hit {
+        std::shared_ptr<Ship> target;
+        std::shared_ptr<Ship> attacker;
+        int firepower;
+    };
+    std::vector<Recorded_hit> recorded_hits;  // kept between updates to reuse its storage
+    struct Scheduled_commands {
+        std::string commands;
+        int period;                             // 0 if they are run only once
+    };
+    Timing_wheel<Scheduled_commands> schedule;
+    std::function<void(const std::string&)> command_runner;
+    
+    // rebuild the island index after islands are added
+    void index_islands();
+    
+    // run the commands scheduled for the current time
+    void run_scheduled_commands();
+    
+    // apply the hits recorded during this update
+    void resolve_combat();
+    
+    // print the close approaches within range and time, each line begun with prefix,
+    // leaving out those between ships that are not moving relative to each other if asked
+    bool print_close_approaches(double range, double time, const char* prefix,
+                                bool moving_only) const;
 };
 
 #endif
\ No newline at end of file
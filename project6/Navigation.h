@@ -58,45 +58,56 @@ To determine where a track will be, add its current Point and
 the Compass_vector for its course and the time to get its new Point:
 	current_track_position + track_compass_vector => new_track_position
 
+Like the Geometry classes, each class is a template on its scalar type and the math policy,
+the plain names use double and the default policy, and the _f names use float.
+Everything is defined here so that it can be inlined where it is used.
 */
 
-#include <iosfwd>
+#include "Geometry.h"
 
-// forward declarations
-struct Point;
-struct Polar_vector;
-struct Course_speed;
-struct Compass_position;
-struct Compass_vector;
+#include <ostream>
+#include <cassert>
+
+template <typename T, typename Math = Default_math> struct Basic_compass_position;
+template <typename T, typename Math = Default_math> struct Basic_course_speed;
+template <typename T, typename Math = Default_math> struct Basic_compass_vector;
 
 /* Compass_position */
 // Compass_position describes a position in terms of bearing and range
-struct Compass_position
+template <typename T, typename Math>
+struct Basic_compass_position
 {
-	double bearing;
-	double range;	
+	using scalar_type = T;
+
+	T bearing;
+	T range;	
 
-	Compass_position (double bearing_ = 0., double range_ = 0.) :
+	constexpr Basic_compass_position (T bearing_ = 0., T range_ = 0.) :
 		bearing(bearing_), range(range_)
 		{}
 
 	// construct a Compass_position from two Points, giving
 	// bearing and range of p2 from p1.
-	Compass_position(const Point& p1, const Point& p2);
+	Basic_compass_position(const Basic_point<T, Math>& p1, const Basic_point<T, Math>& p2) :
+		Basic_compass_position(Basic_polar_vector<T, Math>(p1, p2))
+		{}
 
 	// construct a Compass_position from a Polar_vector
-	Compass_position (const Polar_vector& pv);
+	Basic_compass_position (const Basic_polar_vector<T, Math>& pv);
 };
 
 /* Course_speed */
 // Course_speed describes a compass course and speed. 
 // A Course_speed can not be constructed from any other object.
-struct Course_speed
+template <typename T, typename Math>
+struct Basic_course_speed
 {
-	double course;
-	double speed;	
+	using scalar_type = T;
+
+	T course;
+	T speed;	
 
-	Course_speed (double course_ = 0., double speed_ = 0.) : 
+	constexpr Basic_course_speed (T course_ = 0., T speed_ = 0.) : 
 		course(course_), speed(speed_)
 		{}
 };
@@ -104,49 +115,255 @@ struct Course_speed
 
 /* Compass_vector */
 // Compass_vector describes a displacement in terms of compass direction and distance
-struct Compass_vector
+template <typename T, typename Math>
+struct Basic_compass_vector
 {
-	double direction;
-	double distance;	
+	using scalar_type = T;
 
-	Compass_vector (double direction_ = 0., double distance_ = 0.) : 
+	T direction;
+	T distance;	
+
+	constexpr Basic_compass_vector (T direction_ = 0., T distance_ = 0.) : 
 		direction(direction_), distance(distance_)
 		{}
 
-	Compass_vector (const Polar_vector& pv);
+	Basic_compass_vector (const Basic_polar_vector<T, Math>& pv);
 
 	// construct a Compass_vector from two Points, giving 
 	// the vector for moving from p1 to p2.
-	Compass_vector(const Point& p1, const Point& p2);
-
+	Basic_compass_vector(const Basic_point<T, Math>& p1, const Basic_point<T, Math>& p2) :
+		Basic_compass_vector(Basic_polar_vector<T, Math>(p1, p2))
+		{}
 };
 
-// *** Overloaded operator prototypes ***
+using Compass_position = Basic_compass_position<double>;
+using Course_speed = Basic_course_speed<double>;
+using Compass_vector = Basic_compass_vector<double>;
+
+using Compass_position_f = Basic_compass_position<float>;
+using Course_speed_f = Basic_course_speed<float>;
+using Compass_vector_f = Basic_compass_vector<float>;
+
+// Compass degrees and trig degrees are backwards from each other
+// and are offset by 90 degrees: 
+// 0 trig = 90 compass, 0 compass = 90 trig
+// 180 trig = 270 compass, 180 compass = 270 trig
+// input and is assumed to be positive, and output will be positive
+// this function should never produce an output of 360 instead of zero
+/*
+ 45.00 -> 45.00
+  0.00 -> 90.00
+ 90.00 ->  0.00
+360.00 -> 90.00
+*/
+template <typename Math, typename T>
+inline T to_other_degrees(T deg_in)
+{	
+	return T(Math::wrap_360(360. + 90. - deg_in));
+}
+
+template <typename T, typename Math>
+inline Basic_polar_vector<T, Math> to_Polar_vector(const Basic_compass_vector<T, Math>& cv)
+{
+	return Basic_polar_vector<T, Math>(cv.distance, to_radians(to_other_degrees<Math>(cv.direction)));
+}
+
+template <typename T, typename Math>
+inline Basic_polar_vector<T, Math> to_Polar_vector(const Basic_compass_position<T, Math>& cp)
+{
+	return Basic_polar_vector<T, Math>(cp.range, to_radians(to_other_degrees<Math>(cp.bearing)));
+}
+
+// *** Compass_position members ***
+template <typename T, typename Math>
+Basic_compass_position<T, Math>::Basic_compass_position (const Basic_polar_vector<T, Math>& pv)
+{
+	bearing = to_other_degrees<Math>(to_degrees(pv.theta));
+	range = pv.r;
+}
+
+// *** Compass_vector members ***
+template <typename T, typename Math>
+Basic_compass_vector<T, Math>::Basic_compass_vector (const Basic_polar_vector<T, Math>& pv)
+{
+	direction = to_other_degrees<Math>(to_degrees(pv.theta));
+	distance = pv.r;
+}
+
+// *** Bulk conversions ***
+// The bearings and ranges of n points (x2, y2) from n points (x1, y1), exactly as
+// Compass_position(p1, p2) gives them one at a time; see the bulk conversions in Geometry.h.
+// The Cartesian_vectors between the points are made a block at a time on the stack.
+template <typename Math = Default_math>
+void to_compass_positions(const double* x1, const double* y1, const double* x2, const double* y2,
+	double* bearings, double* ranges, int n)
+{
+	double delta_x[bulk_block_size_c], delta_y[bulk_block_size_c];
+	for (int start = 0; start < n; start += bulk_block_size_c) {
+		int size = n - start < bulk_block_size_c ? n - start : bulk_block_size_c;
+		for (int i = 0; i < size; ++i) {
+			delta_x[i] = x2[start + i] - x1[start + i];
+			delta_y[i] = y2[start + i] - y1[start + i];
+		}
+		to_polar_vectors<Math>(delta_x, delta_y, ranges + start, bearings + start, size);
+		// to_other_degrees, with the wrapping done over the block
+		for (int i = start; i < start + size; ++i)
+			bearings[i] = 360. + 90. - to_degrees(bearings[i]);
+		Math::wrap_360(bearings + start, bearings + start, size);
+	}
+}
+
+// *** Overloaded operators ***
 // Operators are all defined as non-member functions for simplicity in documentation
 
 // Adding a Point and a Compass_position yields a Point
-Point operator+ (const Point& p, const Compass_position& cp);
-Point operator+ (const Compass_position& cp, const Point& p);
+template <typename T, typename Math>
+inline Basic_point<T, Math> operator+ (const Basic_point<T, Math>& p, const Basic_compass_position<T, Math>& cp)
+{
+	return p + to_Polar_vector(cp);
+}
+	
+template <typename T, typename Math>
+inline Basic_point<T, Math> operator+ (const Basic_compass_position<T, Math>& cp, const Basic_point<T, Math>& p)
+{
+	return p + cp;
+}
 
 // Adding a Point and a Compass_vector yields a Point
-Point operator+ (const Point& p, const Compass_vector& cv);
-Point operator+ (const Compass_vector& cv, const Point& p);
+template <typename T, typename Math>
+inline Basic_point<T, Math> operator+ (const Basic_point<T, Math>& p, const Basic_compass_vector<T, Math>& cv)
+{
+	return p + to_Polar_vector(cv);
+}
+
+template <typename T, typename Math>
+inline Basic_point<T, Math> operator+ (const Basic_compass_vector<T, Math>& cv, const Basic_point<T, Math>& p)
+{
+	return p + cv;
+}
+
 
 // Multiplying a Course_speed by a double yields a Compass_vector
-Compass_vector operator* (const Course_speed& cs, double d);
-Compass_vector operator* (double d, const Course_speed& cs);
+// with same angle but scaled distance
+template <typename T, typename Math>
+constexpr Basic_compass_vector<T, Math> operator* (const Basic_course_speed<T, Math>& cs,
+	typename Basic_course_speed<T, Math>::scalar_type d)
+{
+	return Basic_compass_vector<T, Math>(cs.course, cs.speed * d);
+}
+
+template <typename T, typename Math>
+constexpr Basic_compass_vector<T, Math> operator* (typename Basic_course_speed<T, Math>::scalar_type d,
+	const Basic_course_speed<T, Math>& cs)
+{
+	return cs * d;
+}
 
 // Output operator overloads
-std::ostream& operator<< (std::ostream& os, const Course_speed& p);
-std::ostream& operator<< (std::ostream& os, const Compass_position& cp);
-std::ostream& operator<< (std::ostream& os, const Compass_vector& cv);
+
+// output a Course_speed as "course deg, speed nm/hr"
+template <typename T, typename Math>
+std::ostream& operator<< (std::ostream& os, const Basic_course_speed<T, Math>& cs)
+{
+	// if course will round to 360.00 in the output (2 decimal places),
+	// alter the output value to be 0.00; leave the actual direction alone.
+	// The true value of direction is assumed to be always less than exactly 360.
+
+	assert(cs.course < 360.);	// catch a programming error
+
+	T output_course = cs.course;
+	
+	if ((output_course + .005) >= 360.)
+		output_course = 0.00;
+	
+	os << "course " << output_course << " deg, speed " << cs.speed << " nm/hr";
+	return os;
+}
+
+// output a Compass_position as "bearing deg, range nm"
+template <typename T, typename Math>
+std::ostream& operator<< (std::ostream& os, const Basic_compass_position<T, Math>& cp)
+{
+	// if bearing will round to 360.00 in the output (2 decimal places),
+	// alter the output value to be 0.00; leave the actual bearing alone.
+	// The true value of bearing is assumed to be always less than exactly 360.
+
+	assert(cp.bearing < 360.);	// catch a programming error
+
+	T output_bearing = cp.bearing;
+	
+	if ((output_bearing + .005) >= 360.)
+		output_bearing = 0.00;
+	
+	os << "bearing " << output_bearing << " deg, range " << cp.range << " nm";
+	return os;
+}
+
+// output a Compass_vector as "direction deg, distance nm"
+template <typename T, typename Math>
+std::ostream& operator<< (std::ostream& os, const Basic_compass_vector<T, Math>& cv)
+{
+	// if direction will round to 360.00 in the output (2 decimal places),
+	// alter the output value to be 0.00; leave the actual direction alone.
+	// The true value of direction is assumed to be always less than exactly 360.
+
+	assert(cv.direction < 360.);	// catch a programming error
+
+	T output_direction = cv.direction;
+	
+	if ((output_direction + .005) >= 360.)
+		output_direction = 0.00;
+	
+	os << "direction " << output_direction << " deg, distance " << cv.distance << " nm";
+	return os;
+}
 
 // *** Other navigation functions  ***
 
+// *** compute_CPA ***
 // Given ownship's course and speed, and the target's course and speed, and bearing and range from ownship,
 // compute the range and bearing of the point of closest approach and the time until the point.
 // If the CPA is the current position, it is returned with the time being zero.
-Compass_position compute_CPA(Course_speed ownship_cs, Course_speed target_cs, Compass_position target_position_cp, double& time_to_CPA);
+// The algorithm used is based on code written by Al Gerheim.
+template <typename T, typename Math>
+Basic_compass_position<T, Math> compute_CPA(Basic_course_speed<T, Math> ownship_cs, Basic_course_speed<T, Math> target_cs,
+	Basic_compass_position<T, Math> target_position_cp, T& time_to_CPA)
+{
+	using Cartesian = Basic_cartesian_vector<T, Math>;
+	using Polar = Basic_polar_vector<T, Math>;
+
+	// convert the two courses and speeds to Cartesian vectors
+	Cartesian ownship_cv(Polar(ownship_cs.speed, to_radians(to_other_degrees<Math>(ownship_cs.course))));
+	Cartesian target_cv(Polar(target_cs.speed, to_radians(to_other_degrees<Math>(target_cs.course))));
+	// compute a vector for the position of the target right now (time = 0) relative to ownship.
+	Cartesian relative_target_position(to_Polar_vector(target_position_cp));
+	
+	// compute a vector that describes the target's motion relative to ownship,
+	// which is effectively at (0, 0).
+	Cartesian relative_target_motion = target_cv - ownship_cv;
 
+	// compute parameter along relative motion line corresponding to closest point - note similarity to 
+	// distance-from-line computations - this is the time of closest approach.
+	// If relative distance is decreasing, this time will be negative.
+	
+	T t = 	(relative_target_motion.delta_x * relative_target_position.delta_x + 
+				 relative_target_motion.delta_y * relative_target_position.delta_y) 
+				/
+				(relative_target_motion.delta_x * relative_target_motion.delta_x +
+			 	 relative_target_motion.delta_y * relative_target_motion.delta_y);
+	
+	// if t is greater than 0, it means closest point was the initial point, at time = 0.
+	if (t > 0.) {
+		time_to_CPA = 0.;
+		return target_position_cp;
+		}
+		
+	else {
+		time_to_CPA = std::fabs(t);
+		// advance the relative motion vector to time t in the future
+		Cartesian future_target_displacement = time_to_CPA * relative_target_motion;
+		return Basic_compass_position<T, Math>(Polar(relative_target_position + future_target_displacement));
+		}
+}
 
 #endif
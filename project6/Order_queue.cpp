@@ -0,0 +1,244 @@
+#include "Order_queue.h"
+#include "Ship.h"
+#include "Island.h"
+#include "Model.h"
+#include "Island_index.h"
+#include "Utility.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+using std::shared_ptr;
+using std::string;
+using std::vector;
+using std::endl;
+
+static void save_order(std::ostream& os, const Order& order);
+static Order read_order(std::istream& is);
+static shared_ptr<Island> get_island(int id);
+static int get_island_id(const shared_ptr<Island>& island);
+static int get_side_id(const string& side);
+
+// the sides orders have been given for; a side order holds its side's place here
+static vector<string> side_names;
+
+// give the command to unit; may throw whatever the command throws
+void Order::carry_out(Commandable& unit) const {
+    switch (kind) {
+        case Kind::course:
+            unit.set_course_and_speed(value, speed);
+            break;
+        case Kind::position:
+            unit.set_destination_position_and_speed(Point(value, y), speed);
+            break;
+        case Kind::island:
+            unit.set_destination_island_and_speed(get_island(id), speed);
+            break;
+        case Kind::stop:
+            unit.stop();
+            break;
+        case Kind::dock:
+            unit.dock(get_island(id));
+            break;
+        case Kind::refuel:
+            unit.refuel();
+            break;
+        case Kind::load_at:
+            unit.set_load_destination(get_island(id));
+            break;
+        case Kind::unload_at:
+            unit.set_unload_destination(get_island(id));
+            break;
+        case Kind::attack: {
+            shared_ptr<Ship> target_ptr = target.lock();
+            if (!target_ptr)
+                throw Error("Ship not found!");
+            unit.attack(target_ptr);
+            break;
+        }
+        case Kind::stop_attack:
+            unit.stop_attack();
+            break;
+        case Kind::side:
+            unit.set_side(side_names[id]);
+            break;
+        case Kind::patrol:
+            unit.patrol(value);
+            break;
+    }
+}
+
+// read the orders written by save
+Order_queue::Order_queue(std::istream& is) {
+    int count = read_int(is);
+    while (count--)
+        push(read_order(is));
+}
+
+void Order_queue::push(const Order& order) {
+    if (spilled_orders.empty() && back == inline_capacity_c) {
+        // the orders already taken are not moved
+        spilled_orders.assign(std::make_move_iterator(inline_orders.begin() + front),
+                              std::make_move_iterator(inline_orders.end()));
+        back -= front;
+        front = 0;
+    }
+    if (spilled_orders.empty())
+        inline_orders[back] = order;
+    else
+        spilled_orders.push_back(order);
+    ++back;
+}
+
+// remove and return the first order; the queue must not be empty
+Order Order_queue::pop() {
+    Order order = spilled_orders.empty() ? std::move(inline_orders[front])
+                                         : std::move(spilled_orders[front]);
+    if (++front == back)
+        clear();
+    return order;
+}
+
+void Order_queue::clear() {
+    // let go of the islands and ships the orders refer to
+    for (int i = front; i < back && spilled_orders.empty(); ++i)
+        inline_orders[i] = Order();
+    spilled_orders.clear();
+    front = back = 0;
+}
+
+// write the orders in turn, with the names of the islands and ships they refer to
+void Order_queue::save(std::ostream& os) const {
+    os << size() << endl;
+    for (int i = front; i < back; ++i)
+        save_order(os, spilled_orders.empty() ? inline_orders[i] : spilled_orders[i]);
+}
+
+// write an order on a line of its own
+static void save_order(std::ostream& os, const Order& order) {
+    os << (int)order.kind << " " << order.value << " " << order.y << " " << order.speed;
+    bool is_side = order.kind == Order::Kind::side;
+    if (!is_side && order.id != -1)
+        os << " island " << get_island(order.id)->get_name();
+    else
+        os << " no_island";
+    // an order to attack a ship that is gone fails when it is carried out, restored or not
+    if (shared_ptr<Ship> target_ptr = order.target.lock())
+        os << " target " << target_ptr->get_type() << " " << target_ptr->get_name();
+    else
+        os << " no_target";
+    if (is_side)
+        os << " side " << side_names[order.id];
+    else
+        os << " no_side";
+    os << endl;
+}
+
+static Order read_order(std::istream& is) {
+    Order order;
+    order.kind = (Order::Kind)read_int(is);
+    order.value = read_double(is);
+    order.y = read_double(is);
+    order.speed = read_double(is);
+    string word;
+    is >> word;
+    if (word == "island")
+        order.id = get_island_id(read_island_ptr(is));
+    is >> word;
+    if (word == "target")
+        order.target = read_ship_ptr(is);
+    is >> word;
+    if (word == "side") {
+        is >> word;
+        order.id = get_side_id(word);
+    }
+    return order;
+}
+
+// the island with an ID in the Model's island index, which is rebuilt only when the
+// islands are restored, and the ships' orders with them
+static shared_ptr<Island> get_island(int id) {
+    return Model::get_instance().get_island_index().get_island(id);
+}
+
+static int get_island_id(const shared_ptr<Island>& island) {
+    return Model::get_instance().get_island_index().get_id(island);
+}
+
+// the side's place in side_names, added at the end the first time it is seen
+static int get_side_id(const string& side) {
+    auto iter = std::find(side_names.begin(), side_names.end(), side);
+    if (iter != side_names.end())
+        return int(iter - side_names.begin());
+    side_names.push_back(side);
+    return int(side_names.size()) - 1;
+}
+
+Order& Order_recorder::add(Order::Kind kind) {
+    orders.emplace_back();
+    orders.back().kind = kind;
+    return orders.back();
+}
+
+void Order_recorder::set_course_and_speed(double course, double speed) {
+    Order& order = add(Order::Kind::course);
+    order.value = course;
+    order.speed = speed;
+}
+
+void Order_recorder::set_destination_position_and_speed(Point destination_position, double speed) {
+    Order& order = add(Order::Kind::position);
+    order.value = destination_position.x;
+    order.y = destination_position.y;
+    order.speed = speed;
+}
+
+void Order_recorder::set_destination_island_and_speed(shared_ptr<Island> destination_island,
+                                                      double speed) {
+    Order& order = add(Order::Kind::island);
+    order.id = get_island_id(destination_island);
+    order.speed = speed;
+}
+
+void Order_recorder::stop() {
+    add(Order::Kind::stop);
+}
+
+void Order_recorder::dock(shared_ptr<Island> island_ptr) {
+    add(Order::Kind::dock).id = get_island_id(island_ptr);
+}
+
+void Order_recorder::refuel() {
+    add(Order::Kind::refuel);
+}
+
+void Order_recorder::set_load_destination(shared_ptr<Island> load_island) {
+    add(Order::Kind::load_at).id = get_island_id(load_island);
+}
+
+void Order_recorder::set_unload_destination(shared_ptr<Island> unload_island) {
+    add(Order::Kind::unload_at).id = get_island_id(unload_island);
+}
+
+void Order_recorder::attack(shared_ptr<Ship> target_ptr) {
+    add(Order::Kind::attack).target = target_ptr;
+}
+
+void Order_recorder::stop_attack() {
+    add(Order::Kind::stop_attack);
+}
+
+void Order_recorder::set_side(const string& side) {
+    add(Order::Kind::side).id = get_side_id(side);
+}
+
+void Order_recorder::patrol(double radius) {
+    add(Order::Kind::patrol).value = radius;
+}
+
+// the orders are recorded after those already recorded
+void Order_recorder::queue_orders(const vector<Order>& new_orders) {
+    orders.insert(orders.end(), new_orders.begin(), new_orders.end());
+}
@@ -0,0 +1,98 @@
+#ifndef ORDER_QUEUE_H
+#define ORDER_QUEUE_H
+
+#include "Commandable.h"
+#include "Geometry.h"
+
+#include <array>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* An Order is a command given to a ship to be carried out later, once the ship is
+ done with what it is doing. It holds the command and its arguments, already read
+ and checked, and gives them to the ship the same way the Controller would have.
+ Every ship keeps a few Orders of its own, so an Order is kept small: an island or
+ side is held by its ID rather than by pointer or name. */
+
+class Island;
+class Ship;
+
+struct Order {
+    enum class Kind : unsigned char {course, position, island, stop, dock, refuel, load_at,
+                                     unload_at, attack, stop_attack, side, patrol};
+
+    Kind kind = Kind::stop;
+    int id = -1;                    // the island's ID in the Model's island index, or the side's ID
+    double value = 0.;              // the course, the patrol radius, or the x of the destination
+    double y = 0.;                  // the y of the destination
+    double speed = 0.;
+    std::weak_ptr<Ship> target;     // the ship to attack, if it is still there
+
+    // give the command to unit; may throw whatever the command throws
+    void carry_out(Commandable& unit) const;
+};
+
+/* Order_queue holds a ship's orders, first in, first out. Most ships have no orders
+ or only a few, so the first few are kept in the queue itself, and queueing them takes
+ no allocation; only a longer queue is moved out to a vector. */
+class Order_queue {
+public:
+    Order_queue() = default;
+    // read the orders written by save
+    explicit Order_queue(std::istream& is);
+
+    bool empty() const { return front == back; }
+    int size() const { return back - front; }
+
+    void push(const Order& order);
+    // remove and return the first order; the queue must not be empty
+    Order pop();
+    void clear();
+
+    // write the orders in turn, with the names of the islands and ships they refer to
+    void save(std::ostream& os) const;
+
+private:
+    static const int inline_capacity_c = 2;
+    std::array<Order, inline_capacity_c> inline_orders;
+    std::vector<Order> spilled_orders;  // all of the orders, while there are too many to keep inline
+    int front = 0;
+    int back = 0;
+};
+
+/* Order_recorder is a Commandable that turns each command it is given into an Order,
+ so that the Controller can read a command the usual way and queue it for later. */
+class Order_recorder : public Commandable {
+public:
+    const std::vector<Order>& get_orders() const { return orders; }
+
+    void set_course_and_speed(double course, double speed) override;
+    void set_destination_position_and_speed(Point destination_position, double speed) override;
+    void set_destination_island_and_speed(std::shared_ptr<Island> destination_island,
+                                          double speed) override;
+    void stop() override;
+    void dock(std::shared_ptr<Island> island_ptr) override;
+    void refuel() override;
+    void set_load_destination(std::shared_ptr<Island> load_island) override;
+    void set_unload_destination(std::shared_ptr<Island> unload_island) override;
+    void attack(std::shared_ptr<Ship> target_ptr) override;
+    void stop_attack() override;
+    void set_side(const std::string& side) override;
+    void patrol(double radius) override;
+    // the orders are recorded after those already recorded
+    void queue_orders(const std::vector<Order>& new_orders) override;
+    // there are no orders to discard until the recorded ones are queued, so it is only noted
+    void clear_orders() override { discards = true; }
+    // was the unit told to discard the orders it had queued?
+    bool discards_orders() const { return discards; }
+
+private:
+    std::vector<Order> orders;
+    bool discards = false;
+
+    Order& add(Order::Kind kind);
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "Output.h"
+
+#include <charconv>
+#include <iostream>
+
+// the buffer is written out at the end of a line once it holds this much
+const std::size_t write_out_size_c = 1 << 16;
+// the most characters a double shown in fixed point can take: the sign, 309 digits
+// before the point, the point, and the places after it
+const int max_double_chars_c = 320;
+const int double_precision_c = 2;
+
+Output out(&std::cout);
+
+Output::Output(std::ostream* target_) : target(target_) {
+    if (target)
+        buffer.reserve(2 * write_out_size_c);
+}
+
+Output::~Output() {
+    flush();
+}
+
+Output& Output::operator<< (char c) {
+    put(&c, 1);
+    return *this;
+}
+
+Output& Output::operator<< (std::string_view text) {
+    put(text.data(), text.size());
+    return *this;
+}
+
+Output& Output::operator<< (int value) {
+    return put_integer(value);
+}
+
+Output& Output::operator<< (long value) {
+    return put_integer(value);
+}
+
+Output& Output::operator<< (unsigned long value) {
+    return put_integer(value);
+}
+
+Output& Output::operator<< (double value) {
+    return *this << fixed_point(value, double_precision_c);
+}
+
+Output& Output::operator<< (Fixed_point number) {
+    char digits[max_double_chars_c];
+    auto result = std::to_chars(digits, digits + max_double_chars_c, number.value,
+                                std::chars_format::fixed, number.precision);
+    put(digits, result.ptr - digits);
+    return *this;
+}
+
+Output& Output::operator<< (Field_width field) {
+    width = field.width;
+    return *this;
+}
+
+// end the line, and write the buffer out if it has grown large
+Output& Output::end_line() {
+    buffer.push_back('\n');
+    if (target && buffer.size() >= write_out_size_c)
+        write_out();
+    return *this;
+}
+
+// write out the buffer and flush the target
+void Output::flush() {
+    if (!target)
+        return;
+    write_out();
+    target->flush();
+}
+
+// append an item, padded to the width
+void Output::put(const char* text, std::size_t length) {
+    if (width > 0 && length < std::size_t(width))
+        buffer.append(width - length, ' ');
+    width = 0;
+    buffer.append(text, length);
+}
+
+template <typename T>
+Output& Output::put_integer(T value) {
+    // enough for the digits of a 64-bit number and its sign
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    put(digits, result.ptr - digits);
+    return *this;
+}
+
+// move the buffer to the target, without flushing it
+void Output::write_out() {
+    target->write(buffer.data(), buffer.size());
+    buffer.clear();
+}
@@ -0,0 +1,111 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include "Geometry_fwd.h"
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+/* Output is where the simulation writes everything it prints. It is written like
+ cout, with <<, and prints the same text cout did, with doubles shown to two places
+ as main sets cout to show them, but it keeps the text in a buffer that is reused
+ rather than flushing each line. Numbers are formatted with std::to_chars, without
+ the stream's flags and locale. The buffer goes out to cout when flush is called, which
+ the Controller does before it waits for a command, and when it grows large.
+
+ endl here only ends the line; field_width and fixed_point stand in for setw and for
+ setprecision on one number, and apply only to the item after them.
+ */
+
+struct Field_width {
+    int width;
+};
+
+// pad the next item with spaces in front to at least width characters
+inline Field_width field_width(int width)
+{ return Field_width{width}; }
+
+struct Fixed_point {
+    double value;
+    int precision;
+};
+
+// show value with precision places after the point, instead of the usual two
+inline Fixed_point fixed_point(double value, int precision)
+{ return Fixed_point{value, precision}; }
+
+class Output {
+public:
+    // write to target_, or if it is nullptr only keep the text, for get_text
+    explicit Output(std::ostream* target_);
+    // what is left in the buffer is flushed
+    ~Output();
+
+    Output(const Output&) = delete;
+    Output& operator= (const Output&) = delete;
+
+    Output& operator<< (char c);
+    Output& operator<< (const char* text)
+    { return *this << std::string_view(text); }
+    Output& operator<< (const std::string& text)
+    { return *this << std::string_view(text); }
+    Output& operator<< (std::string_view text);
+    Output& operator<< (int value);
+    Output& operator<< (long value);
+    Output& operator<< (unsigned long value);
+    Output& operator<< (double value);
+    Output& operator<< (Fixed_point number);
+    Output& operator<< (Field_width width);
+    Output& operator<< (Output& (*manipulator)(Output&))
+    { return manipulator(*this); }
+
+    // end the line, and write the buffer out if it has grown large
+    Output& end_line();
+
+    // write out the buffer and flush the target
+    void flush();
+
+    // the text not yet written out
+    std::string_view get_text() const
+    { return buffer; }
+    void clear()
+    { buffer.clear(); }
+
+private:
+    std::ostream* target;
+    std::string buffer;
+    int width = 0;      // for the next item only
+
+    // append an item, padded to the width
+    void put(const char* text, std::size_t length);
+    template <typename T>
+    Output& put_integer(T value);
+    // move the buffer to the target, without flushing it
+    void write_out();
+};
+
+// all output goes here, on its way to cout
+extern Output out;
+
+// end a line; unlike std::endl, this leaves flushing to the Controller
+inline Output& endl(Output& output)
+{ return output.end_line(); }
+
+template <typename T, typename Math> struct Basic_course_speed;
+
+// output a Point as "(x, y)"
+template <typename T, typename Math>
+Output& operator<< (Output& output, const Basic_point<T, Math>& p)
+{ return output << '(' << p.x << ", " << p.y << ')'; }
+
+// output a Course_speed as "course deg, speed nm/hr", with a course that rounds
+// to 360.00 shown as 0.00, as on a stream
+template <typename T, typename Math>
+Output& operator<< (Output& output, const Basic_course_speed<T, Math>& cs)
+{
+    T output_course = (cs.course + .005) >= 360. ? 0. : cs.course;
+    return output << "course " << output_course << " deg, speed " << cs.speed << " nm/hr";
+}
+
+#endif
@@ -0,0 +1,545 @@
+#include "Refuel_dispatcher.h"
+#include "Ship.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+using std::vector;
+using std::string;
+using std::pair;
+
+// how far from tight, relative to the row potential, an earlier pair may be and still be kept
+const double tight_tolerance_c = 1e-12;
+
+// the refuel ship, which moves at speed, is waiting at base for a ship to refuel
+void Refuel_dispatcher::add_waiting(Ship* refuel_ship, Point base, double speed) {
+    remove_refuel_ship(refuel_ship);
+    auto iter = classes.find(std::make_pair(std::make_pair(base.x, base.y), speed));
+    if (iter == classes.end()) {
+        iter = classes.emplace(std::make_pair(std::make_pair(base.x, base.y), speed), Class()).first;
+        Class* refuel_class = &iter->second;
+        refuel_class->base = base;
+        refuel_class->speed = speed;
+        // a class that cannot move reaches no ship
+        if (speed > 0.) {
+            bases.insert(refuel_class, base);
+            dead_ships.for_each_in_rect(Point(base.x - range, base.y - range),
+                                        Point(base.x + range, base.y + range),
+                                        [&](Ship* ship, Point location) {
+                double distance = cartesian_distance(location, base);
+                if (distance >= range)
+                    return;
+                Dead_ship& dead_ship = dead.at(ship);
+                refuel_class->edges.push_back(Edge{ship, &dead_ship, distance / speed});
+                dead_ship.reached_by.push_back(refuel_class);
+            });
+        }
+    }
+    Class* refuel_class = &iter->second;
+    auto& members = refuel_class->members;
+    members.insert(std::lower_bound(members.begin(), members.end(), refuel_ship,
+                                    [](const Ship* ship1, const Ship* ship2)
+                                    { return ship1->get_name() < ship2->get_name(); }),
+                   refuel_ship);
+    waiting[refuel_ship->get_name()] = Waiting{refuel_ship, refuel_class};
+    changed.push_back(refuel_class);
+}
+
+// Return the dead ship given to a waiting refuel ship, or nullptr if there is none for it now.
+Ship* Refuel_dispatcher::take_assignment(const Ship* refuel_ship) {
+    if (!changed.empty())
+        solve();
+    auto iter = assignments.find(refuel_ship);
+    if (iter == assignments.end())
+        return nullptr;
+    Ship* ship = iter->second;
+    // the other pairs stay as good as they were, so there is nothing to work out again
+    assignments.erase(iter);
+    stop_waiting(waiting.find(refuel_ship->get_name()), false);
+    add_claim(ship, refuel_ship);
+    return ship;
+}
+
+// the refuel ship stops waiting and gives up the ship it has claimed, if any
+void Refuel_dispatcher::remove_refuel_ship(const Ship* refuel_ship) {
+    auto iter = waiting.find(refuel_ship->get_name());
+    if (iter != waiting.end())
+        stop_waiting(iter, true);
+    auto claimed_iter = claimed.find(refuel_ship);
+    if (claimed_iter == claimed.end())
+        return;
+    const Ship* ship = claimed_iter->second;
+    end_claim(claims.find(ship));
+    set_claimed(ship, false);
+    mark_reaching(ship);
+}
+
+// the refuel ship, which is not waiting, is on its way to the ship, as when restored
+void Refuel_dispatcher::claim(const Ship* ship, const Ship* refuel_ship) {
+    remove_refuel_ship(refuel_ship);
+    // a ship claimed by another refuel ship is taken from it
+    auto claim_iter = claims.find(ship);
+    if (claim_iter != claims.end())
+        end_claim(claim_iter);
+    add_claim(ship, refuel_ship);
+    mark_reaching(ship);
+}
+
+// the ship is now dead in the water at location
+void Refuel_dispatcher::add_ship(Ship* ship, Point location) {
+    auto inserted = dead.emplace(ship, Dead_ship());
+    if (!inserted.second)
+        return;
+    Dead_ship& dead_ship = inserted.first->second;
+    dead_ship.ship = ship;
+    dead_ship.location = location;
+    dead_ship.claimed = claims.count(ship) > 0;
+    dead_ships.insert(ship, location);
+    bases.for_each_in_rect(Point(location.x - range, location.y - range),
+                           Point(location.x + range, location.y + range),
+                           [&](Class* refuel_class, Point base) {
+        double distance = cartesian_distance(location, base);
+        if (distance >= range)
+            return;
+        refuel_class->edges.push_back(Edge{ship, &dead_ship, distance / refuel_class->speed});
+        dead_ship.reached_by.push_back(refuel_class);
+        changed.push_back(refuel_class);
+    });
+}
+
+// the ship is no longer dead in the water, so any claim on it ends
+void Refuel_dispatcher::release_ship(const Ship* ship) {
+    auto claim_iter = claims.find(ship);
+    if (claim_iter != claims.end())
+        end_claim(claim_iter);
+    auto iter = dead.find(ship);
+    if (iter == dead.end())
+        return;
+    Dead_ship& dead_ship = iter->second;
+    for (Class* refuel_class : dead_ship.reached_by) {
+        auto& edges = refuel_class->edges;
+        auto edge = std::find_if(edges.begin(), edges.end(),
+                                 [ship](const Edge& edge) { return edge.ship == ship; });
+        // every class that reaches the ship has an edge to it
+        assert(edge != edges.end());
+        *edge = edges.back();
+        edges.pop_back();
+        // a claimed ship is in no group
+        if (!dead_ship.claimed)
+            changed.push_back(refuel_class);
+    }
+    dead_ships.remove(dead_ship.ship, dead_ship.location);
+    potentials.erase(ship);
+    dead.erase(iter);
+}
+
+void Refuel_dispatcher::clear() {
+    waiting.clear();
+    classes.clear();
+    dead.clear();
+    dead_ships.clear();
+    bases.clear();
+    claims.clear();
+    claimed.clear();
+    assignments.clear();
+    pairs.clear();
+    potentials.clear();
+    changed.clear();
+}
+
+// the refuel ship is no longer waiting; if regroup, the groups it was in are solved again
+void Refuel_dispatcher::stop_waiting(std::map<string, Waiting>::iterator iter, bool regroup) {
+    const Ship* refuel_ship = iter->second.refuel_ship;
+    Class* refuel_class = iter->second.refuel_class;
+    waiting.erase(iter);
+    assignments.erase(refuel_ship);
+    pairs.erase(refuel_ship);
+    potentials.erase(refuel_ship);
+    auto& members = refuel_class->members;
+    members.erase(std::find(members.begin(), members.end(), refuel_ship));
+    if (!members.empty()) {
+        if (regroup)
+            changed.push_back(refuel_class);
+        return;
+    }
+    // the class goes; the others that reached its ships may now pair them differently
+    for (const Edge& edge : refuel_class->edges) {
+        auto& reached_by = edge.dead_ship->reached_by;
+        reached_by.erase(std::find(reached_by.begin(), reached_by.end(), refuel_class));
+        if (regroup && !edge.dead_ship->claimed)
+            changed.insert(changed.end(), reached_by.begin(), reached_by.end());
+    }
+    changed.erase(std::remove(changed.begin(), changed.end(), refuel_class), changed.end());
+    if (refuel_class->speed > 0.)
+        bases.remove(refuel_class, refuel_class->base);
+    classes.erase(std::make_pair(std::make_pair(refuel_class->base.x, refuel_class->base.y),
+                                 refuel_class->speed));
+}
+
+// the groups of the classes that can reach the ship are solved again
+void Refuel_dispatcher::mark_reaching(const Ship* ship) {
+    auto iter = dead.find(ship);
+    if (iter != dead.end())
+        changed.insert(changed.end(), iter->second.reached_by.begin(), iter->second.reached_by.end());
+}
+
+// set whether the ship, if it is dead in the water, is claimed
+void Refuel_dispatcher::set_claimed(const Ship* ship, bool is_claimed) {
+    auto iter = dead.find(ship);
+    if (iter != dead.end())
+        iter->second.claimed = is_claimed;
+}
+
+// the refuel ship claims the ship
+void Refuel_dispatcher::add_claim(const Ship* ship, const Ship* refuel_ship) {
+    claims[ship] = refuel_ship;
+    claimed[refuel_ship] = ship;
+    set_claimed(ship, true);
+}
+
+// the claim on the ship ends; whether the ship is marked as claimed is left to the caller
+void Refuel_dispatcher::end_claim(std::map<const Ship*, const Ship*>::iterator claim_iter) {
+    claimed.erase(claim_iter->second);
+    claims.erase(claim_iter);
+}
+
+/* Pair the waiting refuel ships with the unclaimed dead ships in the groups of the
+ changed classes. A group is gathered from a changed class by following its edges to
+ the unclaimed ships, and from those ships to the other classes that reach them. */
+void Refuel_dispatcher::solve() {
+    ++solves;
+    vector<Class*> starts;
+    starts.swap(changed);
+    vector<Class*> group_classes;
+    vector<Ship*> group_ships;
+    for (Class* start : starts) {
+        if (start->visited == solves)
+            continue;
+        start->visited = solves;
+        group_classes.assign(1, start);
+        group_ships.clear();
+        for (std::size_t i = 0; i < group_classes.size(); ++i) {
+            for (const Edge& edge : group_classes[i]->edges) {
+                Dead_ship* dead_ship = edge.dead_ship;
+                if (dead_ship->claimed || dead_ship->visited == solves)
+                    continue;
+                dead_ship->visited = solves;
+                group_ships.push_back(edge.ship);
+                for (Class* refuel_class : dead_ship->reached_by) {
+                    if (refuel_class->visited != solves) {
+                        refuel_class->visited = solves;
+                        group_classes.push_back(refuel_class);
+                    }
+                }
+            }
+        }
+        for (Class* refuel_class : group_classes)
+            for (Ship* refuel_ship : refuel_class->members)
+                assignments.erase(refuel_ship);
+        if (!group_ships.empty())
+            solve_group(group_classes, group_ships);
+    }
+}
+
+// pair the refuel ships of the classes in a group with its ships
+void Refuel_dispatcher::solve_group(const vector<Class*>& group_classes, const vector<Ship*>& group_ships) {
+    auto by_name = [](const Ship* ship1, const Ship* ship2) { return ship1->get_name() < ship2->get_name(); };
+    if (group_classes.size() == 1) {
+        // the nearest ships go to the refuel ships in name order, ties to the first name
+        const Class* refuel_class = group_classes.front();
+        vector<Edge> edges;
+        for (const Edge& edge : refuel_class->edges)
+            if (!edge.dead_ship->claimed)
+                edges.push_back(edge);
+        auto nearest = edges.begin() + std::min(refuel_class->members.size(), edges.size());
+        std::partial_sort(edges.begin(), nearest, edges.end(), [&by_name](const Edge& e1, const Edge& e2) {
+            return e1.time < e2.time || (e1.time == e2.time && by_name(e1.ship, e2.ship));
+        });
+        for (std::size_t i = 0; i < refuel_class->members.size() && i < edges.size(); ++i)
+            assignments[refuel_class->members[i]] = edges[i].ship;
+        return;
+    }
+
+    // refuel ships by name are the rows, the classes taken in the order of their first
+    // names, and dead ships by name the columns
+    vector<Class*> row_classes(group_classes);
+    std::sort(row_classes.begin(), row_classes.end(), [&by_name](const Class* c1, const Class* c2)
+              { return by_name(c1->members.front(), c2->members.front()); });
+    vector<Ship*> refuelers;
+    vector<const Class*> refueler_classes;
+    for (const Class* refuel_class : row_classes) {
+        for (Ship* refuel_ship : refuel_class->members) {
+            refuelers.push_back(refuel_ship);
+            refueler_classes.push_back(refuel_class);
+        }
+    }
+    vector<Ship*> ships(group_ships);
+    std::sort(ships.begin(), ships.end(), by_name);
+    for (std::size_t i = 0; i < ships.size(); ++i)
+        dead.at(ships[i]).column = int(i);
+
+    /* An unreachable pair costs more than any set of reachable ones, so the solution
+     has as many reachable pairs as there can be, and the least time among those.
+     When there are more refuel ships than dead ships, the columns past the ships
+     stand for no ship, and cost the same as an unreachable one. No time is as long
+     as range at the slowest speed, and no group has more pairs than there are dead
+     ships, so the cost is taken from those rather than from the group, and rounded
+     up to a power of two; it then seldom changes, even as groups merge, and the
+     potentials from the last time still fit. */
+    int n_rows = int(refuelers.size()), n_ships = int(ships.size());
+    int n_columns = std::max(n_rows, n_ships);
+    double slowest = row_classes.front()->speed;
+    for (const Class* refuel_class : row_classes)
+        slowest = std::min(slowest, refuel_class->speed);
+    double unreachable = std::exp2(std::ceil(std::log2((range / slowest + 1.) * (dead.size() + 1.))));
+    vector<double>& costs = cost_matrix;
+    costs.assign(std::size_t(n_rows) * n_columns, unreachable);
+    for (int r = 0; r < n_rows; ++r) {
+        double* row_costs = &costs[std::size_t(r) * n_columns];
+        // the members of a class after the first have the same row as it
+        if (r > 0 && refueler_classes[r] == refueler_classes[r - 1]) {
+            std::copy(row_costs - n_columns, row_costs, row_costs);
+            continue;
+        }
+        for (const Edge& edge : refueler_classes[r]->edges)
+            if (!edge.dead_ship->claimed)
+                row_costs[edge.dead_ship->column] = edge.time;
+    }
+
+    // start from the pairs and potentials of the last time, which mostly still hold
+    vector<double> column_potentials(n_columns, 0.);
+    for (int col = 0; col < n_ships; ++col) {
+        auto iter = potentials.find(ships[col]);
+        if (iter != potentials.end())
+            column_potentials[col] = iter->second;
+    }
+    vector<int> solution(n_rows, -1);
+    int spare = n_ships;
+    for (int r = 0; r < n_rows; ++r) {
+        auto pair_iter = pairs.find(refuelers[r]);
+        if (pair_iter == pairs.end())
+            continue;
+        if (!pair_iter->second) {
+            if (spare < n_columns) {
+                solution[r] = spare;
+                column_potentials[spare++] = potentials[refuelers[r]];
+            }
+            continue;
+        }
+        // the ship may have gone, or be in another group
+        auto dead_iter = dead.find(pair_iter->second);
+        if (dead_iter == dead.end())
+            continue;
+        int col = dead_iter->second.column;
+        if (col < n_ships && ships[col] == pair_iter->second)
+            solution[r] = col;
+    }
+    solve_assignment(costs, n_rows, n_columns, column_potentials, solution);
+
+    for (int col = 0; col < n_ships; ++col)
+        potentials[ships[col]] = column_potentials[col];
+    for (int r = 0; r < n_rows; ++r) {
+        int col = solution[r];
+        if (col < n_ships) {
+            pairs[refuelers[r]] = ships[col];
+            potentials.erase(refuelers[r]);
+        } else {
+            pairs[refuelers[r]] = nullptr;
+            potentials[refuelers[r]] = column_potentials[col];
+        }
+        if (costs[std::size_t(r) * n_columns + col] < unreachable)
+            assignments[refuelers[r]] = ships[col];
+    }
+}
+
+/* Solve the assignment problem for a cost matrix of rows <= columns, given row by row,
+ with the Hungarian algorithm in O(rows * rows * columns). Rows are added one at a time,
+ each along a shortest augmenting path found with the potentials u and v. */
+vector<int> solve_assignment(const vector<double>& costs, int rows, int columns) {
+    vector<double> column_potentials(columns, 0.);
+    vector<int> solution(rows, -1);
+    solve_assignment(costs, rows, columns, column_potentials, solution);
+    return solution;
+}
+
+/* The potentials keep every reduced cost, c - u - v, at least 0 and v at most 0, with
+ the reduced costs of the assigned pairs at 0 and the potentials of the columns left
+ over at 0; the assignment is then the cheapest one. Each row's potential is first set
+ as high as the earlier potentials of the paired columns allow, the other columns' are
+ lowered as far as the rows' then need, and the earlier pairs that are still tight are
+ kept. The rows left without a column are added as usual. A column left over that
+ has a negative potential is then raised to 0 along with the
+ columns reachable from it through tight pairs, lowering their rows' potentials, and
+ if another of those columns reaches 0 first, the pairs along the path to it shift
+ over by one so that that column is the one left over. Each row added and each column
+ raised takes O(rows * columns), so a solve that keeps most pairs is quick. */
+void solve_assignment(const vector<double>& costs, int rows, int columns,
+                      vector<double>& column_potentials, vector<int>& solution) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    auto cost = [&costs, columns](int row, int column) {
+        return costs[std::size_t(row - 1) * columns + (column - 1)];
+    };
+    // index 0 stands for no row or column; row i and column j are at i + 1 and j + 1
+    vector<double> u(rows + 1, 0.), v(columns + 1, 0.);
+    vector<int> row_of(columns + 1, 0), previous(columns + 1, 0);
+    for (int i = 1; i <= rows; ++i) {
+        int j = solution[i - 1] + 1;
+        if (j > 0 && row_of[j] == 0)
+            row_of[j] = i;
+    }
+    bool any_pairs = false;
+    for (int j = 1; j <= columns; ++j) {
+        v[j] = row_of[j] != 0 ? std::min(column_potentials[j - 1], 0.) : 0.;
+        any_pairs = any_pairs || row_of[j] != 0;
+    }
+    // with no pairs to keep, u and v at 0 will do, as the costs are not negative
+    if (any_pairs) {
+        // each row is taken while it is at hand for both; a column without a pair counts
+        // as -infinity for the row's potential, and the lowest of the row's is kept in
+        // four parts, as the additions need not wait on each other
+        vector<double> paired_v(columns + 1), unpaired_v(columns + 1, 0.);
+        for (int j = 1; j <= columns; ++j)
+            paired_v[j] = row_of[j] != 0 ? v[j] : -infinity;
+        for (int i = 1; i <= rows; ++i) {
+            const double* row_costs = &costs[std::size_t(i - 1) * columns] - 1;
+            double lowest[4] = {infinity, infinity, infinity, infinity};
+            int j = 1;
+            for (; j + 3 <= columns; j += 4)
+                for (int k = 0; k < 4; ++k)
+                    lowest[k] = std::min(lowest[k], row_costs[j + k] - paired_v[j + k]);
+            for (; j <= columns; ++j)
+                lowest[0] = std::min(lowest[0], row_costs[j] - paired_v[j]);
+            u[i] = std::min(std::min(lowest[0], lowest[1]), std::min(lowest[2], lowest[3]));
+            // a column without a pair gets the highest potential that leaves the rows' as they are
+            for (j = 1; j <= columns; ++j)
+                unpaired_v[j] = std::min(unpaired_v[j], row_costs[j] - u[i]);
+        }
+        for (int j = 1; j <= columns; ++j)
+            if (row_of[j] == 0)
+                v[j] = unpaired_v[j];
+        // the earlier potentials were reached by sums, so a tight pair may be off by rounding
+        for (int j = 1; j <= columns; ++j)
+            if (row_of[j] != 0 && cost(row_of[j], j) - v[j] > u[row_of[j]] + tight_tolerance_c * (1. + std::fabs(u[row_of[j]])))
+                row_of[j] = 0;
+    }
+    vector<char> assigned(rows + 1, 0);
+    for (int j = 1; j <= columns; ++j)
+        assigned[row_of[j]] = 1;
+
+    vector<double> slack(columns + 1);
+    vector<char> used(columns + 1);
+    for (int i = 1; i <= rows; ++i) {
+        if (assigned[i])
+            continue;
+        row_of[0] = i;
+        int column = 0;
+        std::fill(slack.begin(), slack.end(), infinity);
+        std::fill(used.begin(), used.end(), 0);
+        do {
+            used[column] = 1;
+            int row = row_of[column];
+            double delta = infinity;
+            int next = 0;
+            for (int j = 1; j <= columns; ++j) {
+                if (used[j])
+                    continue;
+                double reduced = cost(row, j) - u[row] - v[j];
+                if (reduced < slack[j]) {
+                    slack[j] = reduced;
+                    previous[j] = column;
+                }
+                if (slack[j] < delta) {
+                    delta = slack[j];
+                    next = j;
+                }
+            }
+            for (int j = 0; j <= columns; ++j) {
+                if (used[j]) {
+                    u[row_of[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    slack[j] -= delta;
+                }
+            }
+            column = next;
+        } while (row_of[column] != 0);
+        // flip the matching along the augmenting path
+        do {
+            int prior = previous[column];
+            row_of[column] = row_of[prior];
+            column = prior;
+        } while (column != 0);
+    }
+
+    // raise the columns left over with a negative potential; every row has a column now
+    vector<int> column_of(rows + 1, 0), reached_from(rows + 1, 0), tree;
+    for (int j = 1; j <= columns; ++j)
+        column_of[row_of[j]] = j;
+    vector<double> row_slack(rows + 1);
+    vector<char> row_used(rows + 1);
+    for (int root = 1; root <= columns; ++root) {
+        if (row_of[root] != 0 || v[root] >= 0.)
+            continue;
+        std::fill(row_slack.begin(), row_slack.end(), infinity);
+        std::fill(row_used.begin(), row_used.end(), 0);
+        tree.assign(1, root);
+        int highest = root;     // the column in the tree with the highest potential
+        int column = root;
+        while (true) {
+            for (int i = 1; i <= rows; ++i) {
+                if (row_used[i])
+                    continue;
+                double reduced = cost(i, column) - u[i] - v[column];
+                if (reduced < row_slack[i]) {
+                    row_slack[i] = reduced;
+                    reached_from[i] = column;
+                }
+            }
+            double delta = -v[highest];
+            int next = 0;
+            for (int i = 1; i <= rows; ++i) {
+                if (!row_used[i] && row_slack[i] < delta) {
+                    delta = row_slack[i];
+                    next = i;
+                }
+            }
+            for (int j : tree)
+                v[j] += delta;
+            for (int i = 1; i <= rows; ++i) {
+                if (row_used[i])
+                    u[i] -= delta;
+                else
+                    row_slack[i] -= delta;
+            }
+            if (next == 0)
+                break;
+            row_used[next] = 1;
+            column = column_of[next];
+            tree.push_back(column);
+            if (v[column] > v[highest])
+                highest = column;
+        }
+        // highest is at 0 now; each row on the path to it moves to the column it was reached from
+        v[highest] = 0.;
+        int row = row_of[highest];
+        row_of[highest] = 0;
+        for (int at = highest; at != root;) {
+            int from = reached_from[row];
+            int next_row = row_of[from];
+            row_of[from] = row;
+            column_of[row] = from;
+            row = next_row;
+            at = from;
+        }
+    }
+
+    for (int j = 1; j <= columns; ++j) {
+        column_potentials[j - 1] = v[j];
+        if (row_of[j] != 0)
+            solution[row_of[j] - 1] = j - 1;
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef REFUEL_DISPATCHER_H
+#define REFUEL_DISPATCHER_H
+
+#include "Geometry.h"
+#include "Spatial_grid.h"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Refuel_dispatcher decides which waiting refuel ship goes to which ship dead in the
+ water. A refuel ship can take a dead ship less than range from its base island. The
+ pairs are chosen so that as many dead ships as possible get a refuel ship, and among
+ those choices the total travel time from the base islands is the least. A dead ship
+ is claimed by the refuel ship it is given to until that refuel ship is done with it,
+ so two refuel ships never go after the same ship.
+
+ Refuel ships with the same base island and speed are interchangeable, so they are
+ taken as one class. The dispatcher is told of each ship as it becomes or stops being
+ dead in the water, and keeps for each class the ships it can reach. The classes and
+ dead ships are split into groups that cannot reach each other's ships; a change
+ marks the classes it touches, and only the groups of those classes are worked out
+ again, the next time a waiting refuel ship looks for its pair. A group of one class
+ takes its nearest ships; any other group is solved with the Hungarian algorithm. A
+ change seldom moves more than a few pairs, so the Hungarian algorithm starts from
+ the pairs and the potentials it ended with the last time, and only finds places for
+ the refuel ships or dead ships whose pairs no longer hold.
+ */
+
+class Ship;
+
+class Refuel_dispatcher {
+public:
+    explicit Refuel_dispatcher(double range_) : range(range_), dead_ships(range_), bases(range_) {}
+
+    Refuel_dispatcher(const Refuel_dispatcher&) = delete;
+    Refuel_dispatcher& operator= (const Refuel_dispatcher&) = delete;
+
+    // the refuel ship, which moves at speed, is waiting at base for a ship to refuel
+    void add_waiting(Ship* refuel_ship, Point base, double speed);
+
+    /* Return the dead ship given to a waiting refuel ship, or nullptr if there is none
+     for it now. The refuel ship stops waiting and the ship is claimed for it. */
+    Ship* take_assignment(const Ship* refuel_ship);
+
+    // the refuel ship stops waiting and gives up the ship it has claimed, if any
+    void remove_refuel_ship(const Ship* refuel_ship);
+
+    // the refuel ship, which is not waiting, is on its way to the ship, as when restored
+    void claim(const Ship* ship, const Ship* refuel_ship);
+
+    // the ship is now dead in the water at location
+    void add_ship(Ship* ship, Point location);
+
+    // the ship is no longer dead in the water, so any claim on it ends
+    void release_ship(const Ship* ship);
+
+    void clear();
+
+private:
+    struct Class;
+    struct Dead_ship;
+
+    struct Waiting {
+        Ship* refuel_ship;
+        Class* refuel_class;
+    };
+
+    struct Edge {
+        Ship* ship;
+        Dead_ship* dead_ship;
+        double time;        // from the base island
+    };
+
+    // the refuel ships waiting at one base with one speed, in name order
+    struct Class {
+        Point base;
+        double speed;
+        std::vector<Ship*> members;
+        std::vector<Edge> edges;        // to every dead ship it can reach, claimed or not
+        int visited = 0;                // the solve that last took it into a group
+    };
+
+    struct Dead_ship {
+        Ship* ship;
+        Point location;
+        std::vector<Class*> reached_by;
+        bool claimed = false;
+        int visited = 0;
+        int column = 0;     // in the group being solved
+    };
+
+    double range;
+    std::map<std::string, Waiting> waiting;         // by refuel ship name
+    std::map<std::pair<std::pair<double, double>, double>, Class> classes;  // by base and speed
+    std::unordered_map<const Ship*, Dead_ship> dead;
+    Spatial_grid<Ship*> dead_ships;
+    Spatial_grid<Class*> bases;                     // the classes that can move
+    std::map<const Ship*, const Ship*> claims;      // dead ship to its refuel ship
+    std::map<const Ship*, const Ship*> claimed;     // refuel ship to its dead ship
+    std::map<const Ship*, Ship*> assignments;       // refuel ship to its dead ship
+    // the Hungarian solution of the last time: the ship of each refuel ship's column,
+    // or nullptr for a column that stands for no ship, and the column potentials, by
+    // the ship of the column, or for a column that stands for no ship by its refuel ship
+    std::map<const Ship*, const Ship*> pairs;
+    std::map<const Ship*, double> potentials;
+    std::vector<Class*> changed;                    // the classes whose groups must be solved again
+    // kept between solves, so that a large matrix is not allocated and paged in each time
+    std::vector<double> cost_matrix;
+    int solves = 0;
+
+    // the refuel ship is no longer waiting; if regroup, the groups it was in are solved again
+    void stop_waiting(std::map<std::string, Waiting>::iterator iter, bool regroup);
+    // the groups of the classes that can reach the ship are solved again
+    void mark_reaching(const Ship* ship);
+    // set whether the ship, if it is dead in the water, is claimed
+    void set_claimed(const Ship* ship, bool is_claimed);
+    // the refuel ship claims the ship, or the claim on the ship ends
+    void add_claim(const Ship* ship, const Ship* refuel_ship);
+    void end_claim(std::map<const Ship*, const Ship*>::iterator claim_iter);
+    void solve();
+    void solve_group(const std::vector<Class*>& group_classes, const std::vector<Ship*>& group_ships);
+};
+
+/* Solve the assignment problem for a cost matrix of rows <= columns, given row by row.
+ Return the column assigned to each row. */
+std::vector<int> solve_assignment(const std::vector<double>& costs, int rows, int columns);
+
+/* The same, starting from the column potentials and the column of each row, or -1, that
+ an earlier solve of a similar matrix ended with; both are replaced with the new ones. */
+void solve_assignment(const std::vector<double>& costs, int rows, int columns,
+                      std::vector<double>& column_potentials, std::vector<int>& solution);
+
+#endif
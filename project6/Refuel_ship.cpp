@@ -3,16 +3,15 @@
 #include "Model.h"
 #include "Utility.h"
 #include "Ship_factory.h"
+#include "Output.h"
+#include "Log.h"
 
 #include <memory>
 #include <iostream>
-#include <set>
 
 using std::string;
 using std::shared_ptr;
-using std::cout;
 using std::endl;
-using std::set;
 
 enum class Refuel_state { not_refueling, moving_to_start, load_refuel, waiting, moving_to_ship, refuel_target, read_to_back };
 
@@ -53,9 +52,10 @@ void Refuel_ship::update() {
         if (cargo_needed < 0.005) {
             cargo = cargo_capacity;
             refuel_state = Refuel_state::waiting;
+            Model::get_instance().add_waiting_refuel_ship(this, base_island->get_location(), get_maximum_speed());
         } else {
             cargo += base_island->provide_fuel(cargo_needed);
-            cout << get_name() << " now has " << cargo << " of cargo" << endl;
+            SIM_LOG(detail, fuel) << get_name() << " now has " << cargo << " of cargo" << endl;
         }
     } else if (refuel_state == Refuel_state::waiting) {
         find_next_ship();
@@ -66,49 +66,54 @@ void Refuel_ship::update() {
                 refuel_state = Refuel_state::refuel_target;
             }
         else if (!is_moving()) { // too far
-            // this can happen when some refuel_ship refueled the ship which moved afterwards
-            // thus this refuel_ship will not meet the target ship and has to go back
-            // if it realizes this is the situation by checking if has stopped but not close to target
+            // the target is claimed for this refuel_ship alone, but if it has moved anyway
+            // this refuel_ship will not meet it and has to go back
+            // it realizes this is the situation by checking if has stopped but not close to target
             refuel_state = Refuel_state::read_to_back;
         }
     } else if ( refuel_state == Refuel_state::refuel_target ) {
         if (!target_ship.expired()) {
             double used = target_ship.lock()->receive_fuel(cargo); // can provide at most cargo amount
-            cout << target_ship.lock()->get_name() << " has received " << used << " of fuel" << endl;
+            SIM_LOG(detail, fuel) << target_ship.lock()->get_name() << " has received " << used << " of fuel" << endl;
             cargo -= used;
         }
         refuel_state = Refuel_state::read_to_back;
     } else if ( refuel_state == Refuel_state::read_to_back ) {
         target_ship.reset();
+        Model::get_instance().remove_refuel_ship(this);
         refuel_state = Refuel_state::moving_to_start;
         Ship::set_destination_island_and_speed(base_island, get_maximum_speed());
     }
 }
 
+std::string Refuel_ship::get_type() const {
+    return "Refuel_ship";
+}
+
 // Perform Refuel_ship-specific behavior in addition to ship describe
 void Refuel_ship::describe() const {
-    cout << "\nRefuel_ship ";
+    out << "\nRefuel_ship ";
     Ship::describe();
     if ( refuel_state == Refuel_state::moving_to_start) {
-        cout << "Moving to base island " << base_island->get_name() << endl;
+        out << "Moving to base island " << base_island->get_name() << endl;
     } else if ( refuel_state == Refuel_state::load_refuel ) {
-        cout << "loading cargo and refueling at " << base_island->get_name() << endl;
+        out << "loading cargo and refueling at " << base_island->get_name() << endl;
     } else if (refuel_state == Refuel_state::waiting) {
-        cout << "waiting at " << base_island->get_name() << endl;
+        out << "waiting at " << base_island->get_name() << endl;
     } else if ( refuel_state == Refuel_state::moving_to_ship ) {
         if (!target_ship.expired()) {
-            cout << "Moving to ship " << target_ship.lock()->get_name() << endl;
+            out << "Moving to ship " << target_ship.lock()->get_name() << endl;
         } else {
-            cout << "Moving to absent ship" << endl;
+            out << "Moving to absent ship" << endl;
         }
     } else if ( refuel_state == Refuel_state::refuel_target ) {
         if (!target_ship.expired()) {
-            cout << "Refueling ship " << target_ship.lock()->get_name() << endl;
+            out << "Refueling ship " << target_ship.lock()->get_name() << endl;
         } else {
-            cout << "Refueling absent ship" << endl;
+            out << "Refueling absent ship" << endl;
         }
     } else if ( refuel_state == Refuel_state::read_to_back ) {
-        cout << "Ready to go back to " << base_island->get_name() << endl;
+        out << "Ready to go back to " << base_island->get_name() << endl;
     }
 }
 
@@ -123,6 +128,7 @@ void Refuel_ship::set_destination_island_and_speed(std::shared_ptr<Island> desti
                                                    double speed) {
     target_ship.reset();
     base_island = destination_island;
+    Model::get_instance().remove_refuel_ship(this);
     refuel_state = Refuel_state::moving_to_start;
     Ship::set_destination_island_and_speed(destination_island, speed);
 }
@@ -137,9 +143,10 @@ void Refuel_ship::set_course_and_speed(double course, double speed) {
 void Refuel_ship::stop() {
     Ship::stop();
     target_ship.reset();
+    Model::get_instance().remove_refuel_ship(this);
     base_island.reset();
     refuel_state = Refuel_state::not_refueling;
-    cout << get_name() <<  " now not in refueling state" << endl;
+    SIM_LOG(info, fuel) << get_name() <<  " now not in refueling state" << endl;
 }
 
 // save ship status to os
@@ -155,11 +162,21 @@ void Refuel_ship::save(std::ostream & os) const {
     if (target_ship.expired()) {
         os << "no_taget" << endl;
     } else {
-        os << "target_ship" << typeid(*target_ship.lock()).name()
+        os << "target_ship " << typeid(*target_ship.lock()).name()
         <<" "<<target_ship.lock()->get_name() << endl;
     }
 }
 
+// wait again for a ship to refuel, or claim again the ship being refueled
+void Refuel_ship::resume_after_restore() {
+    if (refuel_state == Refuel_state::waiting && base_island) {
+        Model::get_instance().add_waiting_refuel_ship(this, base_island->get_location(), get_maximum_speed());
+    } else if ((refuel_state == Refuel_state::moving_to_ship || refuel_state == Refuel_state::refuel_target) &&
+               !target_ship.expired()) {
+        Model::get_instance().claim_for_refuel(this, target_ship.lock().get());
+    }
+}
+
 Refuel_ship& Refuel_ship::operator= (const Refuel_ship& rhs) {
     Ship::operator=(rhs);
     refuel_state = rhs.refuel_state;
@@ -176,34 +193,17 @@ void Refuel_ship::throw_if_in_cycle() {
         throw Error("Refuel_ship in cycle!");
 }
 
-// Find the nearest dead_in_water ship within 20 of base island and set as target
+// Take the dead_in_water ship the Model's dispatcher gives this ship, if any, as target
 void Refuel_ship::find_next_ship() {
-    set<shared_ptr<Ship>, Comp> ships = Model::get_instance().get_ships();
-    double min_distance = -1;
-    shared_ptr<Ship> nearest;
-    for (auto& i : ships) {
-        if ( i->can_move() ) // only dead_in_water ships
-            continue;
-        double distance = cartesian_distance(i->get_location(), base_island->get_location());
-        if ( distance < 20 ) {
-            if ( min_distance < 0 || distance < min_distance ) {
-                min_distance = distance;
-                nearest = i;
-            }
-        }
-    }
-    if ( nearest ) { // is there is such a ship to refuel
+    shared_ptr<Ship> target = Model::get_instance().take_refuel_assignment(this);
+    if ( target ) { // is there is such a ship to refuel
         refuel_state = Refuel_state::moving_to_ship;
-        target_ship = nearest;
-        Ship::set_destination_position_and_speed(nearest->get_location(), get_maximum_speed());
+        target_ship = target;
+        Ship::set_destination_position_and_speed(target->get_location(), get_maximum_speed());
     }
 }
 
-
-
-
-
-
-
-
-
+// the ship is idle only when it is not refueling ships
+bool Refuel_ship::is_idle() const {
+    return Ship::is_idle() && refuel_state == Refuel_state::not_refueling;
+}
@@ -20,6 +20,7 @@ public:
     void update() override;
     
     void describe() const override;
+    std::string get_type() const override;
     
     // throw Error if not in not_refueling; else normal behavior
     void set_destination_position_and_speed(Point destination_point, double speed) override;
@@ -34,9 +35,14 @@ public:
     // stops and forgets Refuel_ship specific information -> becomes not_refueling
     void stop() override;
     void save(std::ostream &) const override;
+    // wait again for a ship to refuel, or claim again the ship being refueled
+    void resume_after_restore() override;
     Refuel_ship& operator= (const Refuel_ship&);
     
 private:
+    // the ship is idle only when it is not refueling ships
+    bool is_idle() const override;
+    
     Refuel_state refuel_state;
     double cargo;
     double cargo_capacity;
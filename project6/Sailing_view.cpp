@@ -1,12 +1,11 @@
 #include "Sailing_view.h"
 #include "Utility.h"
+#include "Output.h"
 #include <iostream>
-#include <iomanip>
 #include <algorithm>
+#include <iterator>
 
 using std::for_each;
-using std::setw;
-using std::cout;
 using std::endl;
 using std::string;
 
@@ -22,19 +21,20 @@ Sailing_view::Sailing_view(std::istream& is) {
     while (memory_size--) {
         string key;
         is >> key;
-        memory[key] = Data(read_double(is), read_double(is), read_double(is));
+        // in braces, so that the numbers are read in the order they were saved
+        memory[key] = Data{read_double(is), read_double(is), read_double(is)};
     }
 }
 
 // prints out textual information about all ships
 void Sailing_view::draw() const {
-    cout << "----- Sailing Data -----" << endl;
-    cout << setw(10) << "Ship" << setw(10) << "Fuel"
-    << setw(10) << "Course" << setw(10) << "Speed" << endl;
+    out << "----- Sailing Data -----" << endl;
+    out << field_width(10) << "Ship" << field_width(10) << "Fuel"
+    << field_width(10) << "Course" << field_width(10) << "Speed" << endl;
     for (const auto& data_pair : memory) {
         auto& data = data_pair.second;
-        cout << setw(10) << data_pair.first << setw(10) << data.fuel
-        << setw(10) << data.course << setw(10) << data.speed << endl;
+        out << field_width(10) << data_pair.first << field_width(10) << data.fuel
+        << field_width(10) << data.course << field_width(10) << data.speed << endl;
     }
 }
 
@@ -58,6 +58,20 @@ void Sailing_view::update_speed(const std::string& name, double speed) {
     memory[name].speed = speed;
 }
 
+/* Save the data of many ships at once. The states usually come in name order,
+ so each is put in right after the one before. */
+void Sailing_view::update_states(const std::vector<Object_state>& states) {
+    if (states.empty())
+        return;
+    auto hint = memory.lower_bound(states.front().name);
+    for (const auto& state : states) {
+        if (!state.is_ship)
+            continue;
+        hint = std::next(memory.insert_or_assign(hint, state.name,
+                                                 Data(state.fuel, state.course, state.speed)));
+    }
+}
+
 void Sailing_view::save(std::ostream &os) const{
     os << "Sailing_view" << endl;
     os << memory.size() << endl;
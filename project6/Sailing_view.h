@@ -33,6 +33,9 @@ public:
     // Save the supplied name and speed for future use in a draw() call
     void update_speed(const std::string& name, double speed) override;
     
+    // Save the data of many ships at once
+    void update_states(const std::vector<Object_state>& states) override;
+    
     // Save the current view status to os
     void save(std::ostream& os) const override;
 private:
@@ -0,0 +1,159 @@
+#include "Scenario.h"
+#include "Command_reader.h"
+#include "Island.h"
+#include "Ship.h"
+#include "Ship_factory.h"
+#include "Utility.h"
+#include "Output.h"
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+using std::string;
+using std::string_view;
+
+namespace {
+
+enum class Declared {island, ship, group};
+
+class Scenario_reader {
+public:
+    explicit Scenario_reader(string_view text) : reader(text) {}
+
+    Scenario read();
+
+private:
+    Command_reader reader;
+    Scenario scenario;
+    std::unordered_map<string, Declared> names;
+    std::set<std::pair<string, string>> views;  // by kind and ship name
+
+    void read_island();
+    void read_ship();
+    void read_group();
+    void read_view();
+
+    // read the name of something being declared; throw Error if it is taken
+    string read_new_name(Declared kind);
+    // read the name of something already declared of that kind
+    string read_declared_name(Declared kind, const char* error_message);
+    double read_double();
+};
+
+Scenario Scenario_reader::read() {
+    try {
+        for (string_view word = reader.read_word(); !word.empty(); word = reader.read_word()) {
+            if (word.front() == '#')
+                reader.skip_line();
+            else if (word == "island")
+                read_island();
+            else if (word == "ship")
+                read_ship();
+            else if (word == "group")
+                read_group();
+            else if (word == "view")
+                read_view();
+            else
+                throw Error("Unrecognized declaration!");
+            if (!reader.peek_word_on_line().empty() && reader.peek_word_on_line().front() != '#')
+                throw Error("Too much on the line!");
+        }
+    } catch (Error&) {
+        // an Error holds only a fixed message, so the line goes out in front of it
+        out << "Scenario line " << reader.get_line_number() << ": ";
+        throw;
+    }
+    // most scenarios are written in name order already
+    auto by_name = [](const auto& object1, const auto& object2)
+        { return object1->get_name() < object2->get_name(); };
+    if (!std::is_sorted(scenario.islands.begin(), scenario.islands.end(), by_name))
+        std::sort(scenario.islands.begin(), scenario.islands.end(), by_name);
+    if (!std::is_sorted(scenario.ships.begin(), scenario.ships.end(), by_name))
+        std::sort(scenario.ships.begin(), scenario.ships.end(), by_name);
+    return std::move(scenario);
+}
+
+// island <name> <x> <y> [<fuel> [<production_rate>]]
+void Scenario_reader::read_island() {
+    string name = read_new_name(Declared::island);
+    Point position{read_double(), read_double()};
+    double fuel = 0., production_rate = 0.;
+    if (!reader.peek_word_on_line().empty() && reader.peek_word_on_line().front() != '#') {
+        fuel = read_double();
+        if (!reader.peek_word_on_line().empty() && reader.peek_word_on_line().front() != '#')
+            production_rate = read_double();
+    }
+    scenario.islands.push_back(std::make_shared<Island>(name, position, fuel, production_rate));
+}
+
+// ship <name> <type> <x> <y>
+void Scenario_reader::read_ship() {
+    string name = read_new_name(Declared::ship);
+    string type(reader.read_word());
+    Point position{read_double(), read_double()};
+    scenario.ships.push_back(create_ship(name, type, position));
+}
+
+// group <name> <member> ...
+void Scenario_reader::read_group() {
+    Scenario::Group_declaration group;
+    group.name = read_new_name(Declared::group);
+    while (!reader.peek_word_on_line().empty() && reader.peek_word_on_line().front() != '#') {
+        string member(reader.read_word());
+        auto iter = names.find(member);
+        if (iter == names.end() || iter->second == Declared::island)
+            throw Error("Group member must be a ship or group declared before it!");
+        group.members.push_back(member);
+    }
+    scenario.groups.push_back(std::move(group));
+}
+
+// view map | sailing | fleet | bridge <ship> | gps <ship>
+void Scenario_reader::read_view() {
+    Scenario::View_declaration view;
+    view.kind = string(reader.read_word());
+    if (view.kind == "bridge" || view.kind == "gps")
+        view.ship_name = read_declared_name(Declared::ship, "Ship not found!");
+    else if (view.kind != "map" && view.kind != "sailing" && view.kind != "fleet")
+        throw Error("Unknow view type");
+    if (!views.emplace(view.kind, view.ship_name).second)
+        throw Error("View is declared twice!");
+    scenario.views.push_back(view);
+}
+
+// read the name of something being declared; throw Error if it is taken
+string Scenario_reader::read_new_name(Declared kind) {
+    string name(reader.read_word());
+    if (name.length() < 2)
+        throw Error("Name is too short!");
+    if (!names.emplace(name, kind).second)
+        throw Error("Name is invalid!");
+    return name;
+}
+
+// read the name of something already declared of that kind
+string Scenario_reader::read_declared_name(Declared kind, const char* error_message) {
+    string name(reader.read_word());
+    auto iter = names.find(name);
+    if (iter == names.end() || iter->second != kind)
+        throw Error(error_message);
+    return name;
+}
+
+double Scenario_reader::read_double() {
+    double number;
+    if (!reader.read_double(number))
+        throw Error("Expected a double!");
+    return number;
+}
+
+} // namespace
+
+/* Read a scenario from text in one pass. Nothing else is changed, so a scenario with
+ a mistake in it is not loaded at all. */
+Scenario read_scenario(string_view text) {
+    return Scenario_reader(text).read();
+}
@@ -0,0 +1,49 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* A Scenario is the world the simulation starts from: its islands, ships, groups and
+ views. It is read from text with one declaration to a line:
+
+     # a comment, to the end of the line
+     island <name> <x> <y> [<fuel> [<production_rate>]]
+     ship <name> <type> <x> <y>
+     group <name> <member> ...
+     view map | sailing | fleet | bridge <ship> | gps <ship>
+
+ The members of a group are ships, or groups declared before it. Names must be at
+ least two characters long and used only once, but unlike the names given to create,
+ they may begin with the same two characters, so that a world can have any number of
+ islands and ships. The Model takes the islands, ships and groups; the Controller
+ opens the views.
+ */
+
+class Island;
+class Ship;
+
+struct Scenario {
+    struct Group_declaration {
+        std::string name;
+        std::vector<std::string> members;
+    };
+    struct View_declaration {
+        std::string kind;
+        std::string ship_name;  // for a bridge or GPS view
+    };
+
+    std::vector<std::shared_ptr<Island>> islands;   // in name order
+    std::vector<std::shared_ptr<Ship>> ships;       // in name order
+    std::vector<Group_declaration> groups;          // in the order declared
+    std::vector<View_declaration> views;
+};
+
+/* Read a scenario from text in one pass. Nothing else is changed, so a scenario with
+ a mistake in it is not loaded at all.
+ may throw Error for a declaration that is not well formed; its line is reported first */
+Scenario read_scenario(std::string_view text);
+
+#endif
@@ -3,13 +3,16 @@
 #include "Island.h"
 #include "Model.h"
 #include "Utility.h"
+#include "View.h"
+#include "Output.h"
+#include "Log.h"
 
 #include <iostream>
 #include <string>
 #include <memory>
+#include <vector>
 
 using std::string;
-using std::cout;
 using std::endl;
 using std::shared_ptr;
 
@@ -23,9 +26,6 @@ are defining it just to get the destructor message output.
 
 const char* const ship_cannot_move_c = "Ship cannot move!";
 
-enum class Ship_state {moving_to_position, docked, stopped, moving_on_course,
-    dead_in_the_water, moving_to_island, sunk};
-
 // initialize, then output constructor message
 Ship::Ship(const string& name_, Point position_, double fuel_capacity_,
            double maximum_speed_, double fuel_consumption_, int resistance_) :
@@ -33,7 +33,8 @@ Sim_object(name_), track_base(position_), fuel(fuel_capacity_),
 fuel_consumption(fuel_consumption_), fuel_capacity(fuel_capacity_),
 maximum_speed(maximum_speed_), resistance(resistance_), ship_state(Ship_state::stopped) {}
 
-Ship::Ship(std::istream& is): Sim_object(is), track_base(read_point(is), Course_speed(read_double(is), read_double(is)), read_double(is)), fuel(read_double(is)),fuel_consumption(read_double(is)), fuel_capacity(read_double(is)), maximum_speed(read_double(is)), resistance(read_double(is)), ship_state((Ship_state)read_int(is)),destination_point(read_point(is)) {
+// the arguments in braces are read in the order they were saved, as they are not in parentheses
+Ship::Ship(std::istream& is): Sim_object(is), track_base{read_point(is), Course_speed{read_double(is), read_double(is)}, read_double(is)}, fuel(read_double(is)),fuel_consumption(read_double(is)), fuel_capacity(read_double(is)), maximum_speed(read_double(is)), resistance(read_double(is)), ship_state((Ship_state)read_int(is)),destination_point(read_point(is)) {
     string line;
     is >> line;
     if (line == "destination_island") {
@@ -43,6 +44,11 @@ Ship::Ship(std::istream& is): Sim_object(is), track_base(read_point(is), Course_
     if (line == "docked_island") {
         docked_Island = read_island_ptr(is);
     }
+    is >> line;
+    if (line == "side") {
+        is >> side;
+    }
+    orders = Order_queue(is);
 }
 
 /*** Readers ***/
@@ -81,51 +87,71 @@ double Ship::receive_fuel(double received) {
     double actual = (fuel + received > fuel_capacity) ? (fuel_capacity - fuel) : (received);
     fuel += actual;
     Model::get_instance().notify_fuel(get_name(), fuel);
-    ship_state = Ship_state::stopped;
+    set_state(Ship_state::stopped);
     return actual;
 }
 
 /*** Interface to derived classes ***/
 
-// output a description of current state to cout
+// output a description of current state to out
 void Ship::describe() const {
-    cout << get_name() << " at " << get_location();
+    out << get_name() << " at " << get_location();
     if (ship_state == Ship_state::sunk) {
-        cout << get_name() << " sunk" << endl;
+        out << get_name() << " sunk" << endl;
     } else {
-        cout << ", fuel: " << fuel << " tons, resistance: " << resistance << endl;
+        out << ", fuel: " << fuel << " tons, resistance: " << resistance << endl;
         if (ship_state == Ship_state::moving_to_position)
-            cout << "Moving to " << destination_point << " on "
+            out << "Moving to " << destination_point << " on "
                  << track_base.get_course_speed() << endl;
         else if (ship_state == Ship_state::moving_to_island)
-            cout << "Moving to " << destination_Island->get_name() << " on "
+            out << "Moving to " << destination_Island->get_name() << " on "
                  << track_base.get_course_speed() << endl;
         else if (ship_state == Ship_state::moving_on_course)
-            cout << "Moving on " << track_base.get_course_speed() << endl;
+            out << "Moving on " << track_base.get_course_speed() << endl;
         else if (ship_state == Ship_state::docked)
-            cout << "Docked at " << destination_Island->get_name() << endl;
+            out << "Docked at " << destination_Island->get_name() << endl;
         else if (ship_state == Ship_state::stopped)
-            cout << "Stopped" << endl;
+            out << "Stopped" << endl;
         else if (ship_state == Ship_state::dead_in_the_water)
-            cout << "Dead in the water" << endl;
+            out << "Dead in the water" << endl;
+        if (!side.empty())
+            out << "On side " << side << endl;
+        if (!orders.empty())
+            out << "Orders queued: " << orders.size() << endl;
     }
 }
 
 void Ship::broadcast_current_state() const {
+    Model::get_instance().notify_ship_state(get_name(), get_type(), ship_state);
+    Model::get_instance().notify_attacking(get_name(), is_attacking());
     Model::get_instance().notify_location(get_name(), get_location());
     Model::get_instance().notify_fuel(get_name(), fuel);
     Model::get_instance().notify_course(get_name(), track_base.get_course());
     Model::get_instance().notify_speed(get_name(), track_base.get_speed());
 }
 
+Object_state Ship::get_current_state() const {
+    Object_state state;
+    state.name = get_name();
+    state.location = get_location();
+    state.is_ship = true;
+    state.fuel = fuel;
+    state.course = track_base.get_course();
+    state.speed = track_base.get_speed();
+    state.type = get_type();
+    state.ship_state = ship_state;
+    state.attacking = is_attacking();
+    return state;
+}
+
 
 /* Start moving to a destination position at a speed */
 void Ship::set_destination_position_and_speed(Point destination_position, double speed) {
     set_course_speed_and_dest(destination_position, speed);
     docked_Island = nullptr;
     destination_Island = nullptr;
-    ship_state = Ship_state::moving_to_position;
-    cout << get_name() << " will sail on " << track_base.get_course_speed()
+    set_state(Ship_state::moving_to_position);
+    SIM_LOG(info, movement) << get_name() << " will sail on " << track_base.get_course_speed()
          << " to " << destination_point << endl;
 }
 
@@ -134,8 +160,8 @@ void Ship::set_destination_island_and_speed(shared_ptr<Island> destination_islan
     set_course_speed_and_dest(destination_island->get_location(), speed);
     docked_Island = nullptr;
     destination_Island = destination_island;
-    ship_state = Ship_state::moving_to_island;
-    cout << get_name() << " will sail on " << track_base.get_course_speed()
+    set_state(Ship_state::moving_to_island);
+    SIM_LOG(info, movement) << get_name() << " will sail on " << track_base.get_course_speed()
          << " to " << destination_island->get_name() << endl;
 }
 
@@ -158,8 +184,8 @@ void Ship::set_course_and_speed(double course, double speed) {
     Model::get_instance().notify_speed(get_name(), track_base.get_speed());
     docked_Island = nullptr;
     destination_Island = nullptr;
-    ship_state = Ship_state::moving_on_course;
-    cout << get_name() << " will sail on " << track_base.get_course_speed() << endl;
+    set_state(Ship_state::moving_on_course);
+    SIM_LOG(info, movement) << get_name() << " will sail on " << track_base.get_course_speed() << endl;
 }
 
 /* Check if ship can move and if speed is too large */
@@ -176,8 +202,8 @@ void Ship::stop() {
         throw Error(ship_cannot_move_c);
     track_base.set_speed(0.);
     Model::get_instance().notify_speed(get_name(), track_base.get_speed());
-    cout << get_name() << " stopping at " << get_location() << endl;
-    ship_state = Ship_state::stopped;
+    SIM_LOG(info, movement) << get_name() << " stopping at " << get_location() << endl;
+    set_state(Ship_state::stopped);
 }
 
 /* dock at an Island - set our position = Island's position, go into Docked state */
@@ -186,11 +212,13 @@ void Ship::dock(shared_ptr<Island> island_ptr) {
         cartesian_distance(get_location(), island_ptr->get_location()) > 0.1) {
         throw Error("Can't dock!");
     }
+    Point old_location = get_location();
     track_base.set_position(island_ptr->get_location());
+    Model::get_instance().ship_moved(this, old_location);
     docked_Island = island_ptr;
     Model::get_instance().notify_location(get_name(), get_location());
-    ship_state = Ship_state::docked;
-    cout << get_name() <<  " docked at " << island_ptr->get_name() << endl;
+    set_state(Ship_state::docked);
+    SIM_LOG(info, movement) << get_name() <<  " docked at " << island_ptr->get_name() << endl;
 }
 
 /* Refuel - must already be docked at an island; fill takes as much as possible */
@@ -202,7 +230,7 @@ void Ship::refuel() {
         fuel = fuel_capacity;
     } else {
         fuel += docked_Island->provide_fuel(fuel_needed);
-        cout << get_name() << " now has " << fuel << " tons of fuel" << endl;
+        SIM_LOG(info, fuel) << get_name() << " now has " << fuel << " tons of fuel" << endl;
     }
     Model::get_instance().notify_fuel(get_name(), fuel);
 }
@@ -224,6 +252,46 @@ void Ship::stop_attack() {
     throw Not_have_ability("Cannot attack!");
 }
 
+void Ship::set_side(const std::string& side_) {
+    side = side_;
+    SIM_LOG(info, combat) << get_name() << " is on side " << side << endl;
+}
+
+void Ship::patrol(double radius) {
+    throw Not_have_ability("Cannot patrol!");
+}
+
+// add orders to carry out in turn, once the ship is done with what it is doing
+void Ship::queue_orders(const std::vector<Order>& new_orders) {
+    for (const auto& order : new_orders)
+        orders.push(order);
+}
+
+// discard the orders not yet carried out
+void Ship::clear_orders() {
+    orders.clear();
+}
+
+/* Return true if the ship can take its next order: it is afloat and can move, it is
+ stopped or docked, and it is not busy with work of its own, such as a cargo run. */
+bool Ship::is_idle() const {
+    return ship_state == Ship_state::stopped || ship_state == Ship_state::docked;
+}
+
+/* Carry out the queued orders in turn until one of them keeps the ship busy. An order
+ that fails ends the rest of them, as the ship may not be where they expect it to be. */
+void Ship::carry_out_orders() {
+    while (!orders.empty() && is_idle()) {
+        Order order = orders.pop();
+        try {
+            order.carry_out(*this);
+        } catch (const Error& error) {
+            out << get_name() << " cannot carry out its orders: " << error.what() << endl;
+            orders.clear();
+        }
+    }
+}
+
 void Ship::save(std::ostream& os) const {
     Sim_object::save(os);
     os << track_base.get_position() << endl;
@@ -240,6 +308,12 @@ void Ship::save(std::ostream& os) const {
     } else {
         os << "no_docked_island" << endl;
     }
+    if (!side.empty()) {
+        os << "side " << side << endl;
+    } else {
+        os << "no_side" << endl;
+    }
+    orders.save(os);
 }
 
 // copy assignment
@@ -256,6 +330,8 @@ Ship& Ship::operator= (const Ship& in_ship) {
     destination_point = in_ship.destination_point;
     destination_Island = in_ship.destination_Island;
     docked_Island = in_ship.docked_Island;
+    side = in_ship.side;
+    orders = in_ship.orders;
     return *this;
 }
 
@@ -263,11 +339,11 @@ Ship& Ship::operator= (const Ship& in_ship) {
 /* interactions with other objects. Receive a hit from an attacker */
 void Ship::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr) {
     resistance -= hit_force;
-    cout << get_name() << " hit with " << hit_force
+    SIM_LOG(notice, combat) << get_name() << " hit with " << hit_force
          << ", resistance now " << resistance << endl;
     if (resistance < 0) {
-        cout << get_name() << " sunk" << endl;
-        ship_state = Ship_state::sunk;
+        SIM_LOG(notice, combat) << get_name() << " sunk" << endl;
+        set_state(Ship_state::sunk);
         track_base.set_speed(0.);
         Model::get_instance().notify_speed(get_name(), track_base.get_speed());
         Model::get_instance().notify_gone(get_name());
@@ -277,26 +353,42 @@ void Ship::receive_hit(int hit_force, shared_ptr<Ship> attacker_ptr) {
 
 // Update the state of the Ship
 void Ship::update() {
+    // an idle ship takes its next orders before it moves
+    if (!orders.empty() && is_idle())
+        carry_out_orders();
     // Afloat states
     if (is_afloat()) {
         if (is_moving()) {
+            Point old_location = get_location();
             calculate_movement();
-            cout << get_name() << " now at " << get_location() << endl;
+            Model::get_instance().ship_moved(this, old_location);
+            SIM_LOG(detail, movement) << get_name() << " now at " << get_location() << endl;
             Model::get_instance().notify_location(get_name(), get_location());
         } else if (ship_state == Ship_state::stopped) {
-            cout << get_name() << " stopped at " << get_location() << endl;
+            SIM_LOG(detail, movement) << get_name() << " stopped at " << get_location() << endl;
         } else if (is_docked()) {
-            cout << get_name() << " docked at " << destination_Island->get_name() << endl;
+            SIM_LOG(detail, movement) << get_name() << " docked at " << destination_Island->get_name() << endl;
         } else if (ship_state == Ship_state::dead_in_the_water) {
-            cout << get_name() << " dead in the water at " << get_location() << endl;
+            SIM_LOG(detail, movement) << get_name() << " dead in the water at " << get_location() << endl;
         }
     } else {
-        cout << get_name() << " sunk" << endl;
+        SIM_LOG(detail, combat) << get_name() << " sunk" << endl;
     }
 }
 
 
 
+// change the state, and tell the views if it is a different one
+void Ship::set_state(Ship_state new_state) {
+    if (new_state == ship_state)
+        return;
+    bool was_dead = ship_state == Ship_state::dead_in_the_water;
+    ship_state = new_state;
+    if (was_dead || ship_state == Ship_state::dead_in_the_water)
+        Model::get_instance().update_dead_in_water(this);
+    Model::get_instance().notify_ship_state(get_name(), get_type(), ship_state);
+}
+
 /*
 Calculate the new position of a ship based on how it is moving, its speed, and
 fuel state. This function should be called only if the state is 
@@ -345,7 +437,7 @@ void Ship:: calculate_movement()
 		fuel -= fuel_required;
 		track_base.set_speed(0.);
         Model::get_instance().notify_speed(get_name(), track_base.get_speed());
-		ship_state = Ship_state::stopped;
+		set_state(Ship_state::stopped);
     } else {
 		// go as far as we can, stay in the same movement state
 		// simply move for the amount of time possible
@@ -355,7 +447,7 @@ void Ship:: calculate_movement()
 			fuel = 0.0;
             track_base.set_speed(0.);
             Model::get_instance().notify_speed(get_name(), track_base.get_speed());
-			ship_state = Ship_state::dead_in_the_water;
+			set_state(Ship_state::dead_in_the_water);
 			}
 		else {
 			fuel -= full_fuel_required;
@@ -4,6 +4,7 @@
 #include "Sim_object.h"
 #include "Commandable.h"
 #include "Track_base.h"
+#include "Order_queue.h"
 
 #include <memory>
 
@@ -24,7 +25,9 @@ The is a "fat interface" for the capabilities of derived types of Ships. These
 functions are implemented in this class to throw an Error exception.
 */
 
-enum class Ship_state;
+// The movement states of a Ship; the views and the Model also keep track of them.
+enum class Ship_state {moving_to_position, docked, stopped, moving_on_course,
+    dead_in_the_water, moving_to_island, sunk};
 
 class Island;
 
@@ -33,6 +36,26 @@ public:
 	/*** Readers ***/
 	// return the current position
     Point get_location() const override {return track_base.get_position();}
+    
+    // return the name of the kind of Ship, e.g. "Cruiser"
+    virtual std::string get_type() const = 0;
+    
+    Ship_state get_state() const {return ship_state;}
+    
+    double get_fuel() const {return fuel;}
+    
+    // return the track, for motion analysis against other tracks
+    const Track_base& get_track() const {return track_base;}
+    
+    // Return true if ship is attacking a target
+    virtual bool is_attacking() const {return false;}
+    
+    // return the side the ship fights on, or an empty string if it takes no side
+    const std::string& get_side() const {return side;}
+    
+    // Return true if both ships take sides and the sides are different
+    bool is_hostile_to(const Ship& other) const
+    {return !side.empty() && !other.side.empty() && side != other.side;}
 	
 	// Return true if ship can move (it is not dead in the water or in the process or sinking); 
 	bool can_move() const;
@@ -60,6 +83,7 @@ public:
 	void describe() const override;
 	
 	void broadcast_current_state()  const override;
+	Object_state get_current_state() const override;
     
     // interactions with other objects
     // receive a hit from an attacker
@@ -109,9 +133,25 @@ public:
     // will always throw Error("Cannot attack!");
     void stop_attack() override;
     
+    // set the side the ship fights on
+    void set_side(const std::string& side_) override;
+    
+    // will always throw Error("Cannot patrol!");
+    void patrol(double radius) override;
+    
+    // add orders to carry out in turn, once the ship is done with what it is doing
+    void queue_orders(const std::vector<Order>& new_orders) override;
+    
+    // discard the orders not yet carried out
+    void clear_orders() override;
+    
     // save ship status to os
     void save(std::ostream&) const override;
     
+    // take up again, once the Model has restored every ship, what the ship was doing
+    // with the others
+    virtual void resume_after_restore() {}
+    
     virtual Ship& operator= (const Ship&);
     
 protected:
@@ -128,6 +168,10 @@ protected:
 	// return pointer to current destination Island, nullptr if not set
     std::shared_ptr<Island> get_destination_Island() const
     {return destination_Island;}
+    
+    /* Return true if the ship can take its next order: it is afloat and can move, it is
+     stopped or docked, and it is not busy with work of its own, such as a cargo run. */
+    virtual bool is_idle() const;
 
 private:
     Track_base track_base;
@@ -140,9 +184,15 @@ private:
 	Point destination_point;                // Current destination position
     std::shared_ptr<Island> destination_Island;	// Current destination Island, if any
     std::shared_ptr<Island> docked_Island;
+    std::string side;
+    Order_queue orders;                     // to carry out in turn, once the ship is idle
 
 	// Updates position, fuel, and movement_state, assuming 1 time unit (1 hr)
 	void calculate_movement();
+    // carry out the queued orders in turn until one of them keeps the ship busy
+    void carry_out_orders();
+    // change the state, and tell the views if it is a different one
+    void set_state(Ship_state new_state);
     void set_course_speed_and_dest(Point destination_position, double speed);
     void check_state_and_speed(double speed);
 };
@@ -9,6 +9,8 @@
 #include "Model.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 using std::shared_ptr;
 
 /* This is a very simple form of factory, a function; you supply the information, it creates
@@ -31,6 +33,44 @@ shared_ptr<Ship> create_ship(const std::string& name, const std::string& type,
         throw Error("Trying to create ship of unknown type!");
 }
 
+template <typename T>
+shared_ptr<Ship> make_ship(const std::string& name, Point position) {
+    return std::make_shared<T>(name, position);
+}
+
+/* create a fleet of ships of one type, one at each position, named prefix followed by
+ their number with zeros in front; the type is looked up once for the whole fleet */
+std::vector<shared_ptr<Ship>> create_fleet(const std::string& prefix, const std::string& type,
+                                           const std::vector<Point>& positions) {
+    shared_ptr<Ship> (*make)(const std::string&, Point) = nullptr;
+    if (type == "Cruiser")
+        make = make_ship<Cruiser>;
+    else if (type == "Tanker")
+        make = make_ship<Tanker>;
+    else if (type == "Cruise_ship")
+        make = make_ship<Cruise_ship>;
+    else if (type == "Torpedo_boat")
+        make = make_ship<Torpedo_boat>;
+    else if (type == "Refuel_ship")
+        make = make_ship<Refuel_ship>;
+    else
+        throw Error("Trying to create ship of unknown type!");
+
+    std::size_t width = std::to_string(positions.size()).size();
+    std::string name = prefix + std::string(width, '0');
+    std::vector<shared_ptr<Ship>> fleet;
+    fleet.reserve(positions.size());
+    for (Point position : positions) {
+        // count up in the digits of the name, carrying from the right
+        std::size_t digit = name.size();
+        while (name[--digit] == '9')
+            name[digit] = '0';
+        ++name[digit];
+        fleet.push_back(make(name, position));
+    }
+    return fleet;
+}
+
 template <typename T>
 void update_model_ship(const shared_ptr<Ship> new_ship) {
     if (Model::get_instance().is_ship_present(new_ship->get_name())) {
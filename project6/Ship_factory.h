@@ -1,11 +1,11 @@
 #ifndef SHIP_FACTORY_H
 #define SHIP_FACTORY_H
 
+#include "Geometry_fwd.h"
 #include <string>
 #include <iosfwd>
 #include <memory>
-
-struct Point;
+#include <vector>
 
 class Ship;
 /* This is a very simple form of factory, a function; you supply the information, it creates
@@ -17,5 +17,12 @@ with new, so some other component is resposible for deleting it.
 std::shared_ptr<Ship> create_ship(const std::string& name, const std::string& type,
                                   Point initial_position);
 
+/* create a fleet of ships of one type, one at each position, named prefix followed by
+ their number counting from 1, with zeros in front so that all the numbers are the same
+ length; the ships are returned in name order.
+ may throw Error("Trying to create ship of unknown type!") */
+std::vector<std::shared_ptr<Ship>> create_fleet(const std::string& prefix, const std::string& type,
+                                                const std::vector<Point>& positions);
+
 std::shared_ptr<Ship> restore_ship(std::istream&);
 #endif
@@ -4,9 +4,10 @@
 object's name, and has pure virtual accessor functions for the object's position
 and other information. */
 
+#include "Geometry_fwd.h"
 #include <string>
 #include <iosfwd>
-struct Point;
+struct Object_state;
 
 class Sim_object {
 public:
@@ -21,6 +22,8 @@ public:
 	/* Interface for derived classes */
 	// ask model to notify views of current state
     virtual void broadcast_current_state() const = 0;
+    // return the current state in the form the views take it
+    virtual Object_state get_current_state() const = 0;
     virtual Point get_location() const = 0;
     virtual void describe() const = 0;
     virtual void update() = 0;
@@ -0,0 +1,163 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "Geometry.h"
+
+#include <unordered_map>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+/* Spatial_grid is a uniform bucket grid that indexes items by their location.
+ The plane is cut into square cells of a fixed size, and each non-empty cell keeps
+ the items that are located in it. A query only visits the cells that overlap
+ the query region, so its cost depends on how many items are near that region,
+ not on how many items are in the grid. The grid does not remember where an item
+ is on its own; the caller supplies the old location when an item moves or is removed.
+ */
+
+template <typename T>
+class Spatial_grid {
+public:
+    explicit Spatial_grid(double cell_size_ = 10.) : cell_size(cell_size_) {}
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    void clear() { cells.clear(); count = 0; }
+
+    // add an item at location
+    void insert(const T& item, Point location);
+
+    // remove an item that was inserted at location; no error if it is not present
+    void remove(const T& item, Point location);
+
+    // move an item from old_location to new_location
+    void move(const T& item, Point old_location, Point new_location);
+
+    /* Call func(item, location) for each item inside the rectangle given by its
+     lower-left and upper-right corners, bounds included. Items are visited in
+     no particular order. */
+    template <typename F>
+    void for_each_in_rect(Point lower_left, Point upper_right, F func) const;
+
+    // Call func(item, location) for each item no farther than radius from center.
+    template <typename F>
+    void for_each_in_circle(Point center, double radius, F func) const;
+
+private:
+    struct Entry {
+        T item;
+        Point location;
+    };
+    using Cell_key = std::int64_t;
+
+    double cell_size;
+    int count = 0;
+    std::unordered_map<Cell_key, std::vector<Entry>> cells;
+
+    int to_cell(double coordinate) const;
+    static Cell_key make_key(int ix, int iy)
+    { return (Cell_key(ix) << 32) | std::uint32_t(iy); }
+};
+
+template <typename T>
+void Spatial_grid<T>::insert(const T& item, Point location) {
+    cells[make_key(to_cell(location.x), to_cell(location.y))].push_back(Entry{item, location});
+    ++count;
+}
+
+template <typename T>
+void Spatial_grid<T>::remove(const T& item, Point location) {
+    auto cell = cells.find(make_key(to_cell(location.x), to_cell(location.y)));
+    if (cell == cells.end())
+        return;
+    auto& entries = cell->second;
+    for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+        if (iter->item == item) {
+            // order inside a cell does not matter, so fill the hole with the last entry
+            *iter = entries.back();
+            entries.pop_back();
+            --count;
+            break;
+        }
+    }
+    // drop empty cells so that the number of cells stays proportional to the items
+    if (entries.empty())
+        cells.erase(cell);
+}
+
+template <typename T>
+void Spatial_grid<T>::move(const T& item, Point old_location, Point new_location) {
+    Cell_key old_key = make_key(to_cell(old_location.x), to_cell(old_location.y));
+    Cell_key new_key = make_key(to_cell(new_location.x), to_cell(new_location.y));
+    if (old_key != new_key) {
+        remove(item, old_location);
+        insert(item, new_location);
+        return;
+    }
+    auto cell = cells.find(old_key);
+    if (cell == cells.end())
+        return;
+    for (auto& entry : cell->second) {
+        if (entry.item == item) {
+            entry.location = new_location;
+            return;
+        }
+    }
+}
+
+template <typename T>
+template <typename F>
+void Spatial_grid<T>::for_each_in_rect(Point lower_left, Point upper_right, F func) const {
+    auto inside = [&lower_left, &upper_right](Point p) {
+        return p.x >= lower_left.x && p.x <= upper_right.x &&
+               p.y >= lower_left.y && p.y <= upper_right.y;
+    };
+    int ix_min = to_cell(lower_left.x), ix_max = to_cell(upper_right.x);
+    int iy_min = to_cell(lower_left.y), iy_max = to_cell(upper_right.y);
+    double rect_cells = (double(ix_max) - ix_min + 1.) * (double(iy_max) - iy_min + 1.);
+    // a rectangle covering more cells than are occupied is cheaper to answer by
+    // walking the occupied cells
+    if (rect_cells > cells.size()) {
+        for (const auto& cell : cells)
+            for (const auto& entry : cell.second)
+                if (inside(entry.location))
+                    func(entry.item, entry.location);
+        return;
+    }
+    for (int ix = ix_min; ix <= ix_max; ++ix) {
+        for (int iy = iy_min; iy <= iy_max; ++iy) {
+            auto cell = cells.find(make_key(ix, iy));
+            if (cell == cells.end())
+                continue;
+            for (const auto& entry : cell->second)
+                if (inside(entry.location))
+                    func(entry.item, entry.location);
+        }
+    }
+}
+
+template <typename T>
+template <typename F>
+void Spatial_grid<T>::for_each_in_circle(Point center, double radius, F func) const {
+    for_each_in_rect(Point(center.x - radius, center.y - radius),
+                     Point(center.x + radius, center.y + radius),
+                     [&center, radius, &func](const T& item, Point location) {
+                         if (cartesian_distance(center, location) <= radius)
+                             func(item, location);
+                     });
+}
+
+// Return the cell coordinate, clamped so that far-off or invalid values stay in range.
+template <typename T>
+int Spatial_grid<T>::to_cell(double coordinate) const {
+    const double limit = 1 << 30;
+    double cell = std::floor(coordinate / cell_size);
+    if (!(cell > -limit))   // also catches NaN
+        return -(1 << 30);
+    if (cell > limit)
+        return 1 << 30;
+    return int(cell);
+}
+
+#endif
@@ -2,11 +2,12 @@
 #include "Island.h"
 #include "Utility.h"
 #include "Model.h"
+#include "Output.h"
+#include "Log.h"
 
 #include <iostream>
 #include <memory>
 
-using std::cout;
 using std::endl;
 using std::shared_ptr;
 
@@ -31,6 +32,10 @@ Tanker::Tanker(std::istream& is): Ship(is), cargo(read_double(is)), cargo_capaci
     }
 }
 
+std::string Tanker::get_type() const {
+    return "Tanker";
+}
+
 // If Tanker has assigned cargo destinations, throw Error.
 void Tanker::set_destination_position_and_speed(Point destination_point, double speed) {
     throw_if_in_cycle();
@@ -57,7 +62,7 @@ void Tanker::set_load_destination(shared_ptr<Island> load_island) {
     load_destination = load_island;
     if (load_destination == unload_destination)
         throw Error(load_unload_the_same_c);
-    cout << get_name() << " will load at " << load_island->get_name() << endl;
+    SIM_LOG(info, cargo) << get_name() << " will load at " << load_island->get_name() << endl;
     start_cycle_if_ready();
 }
 
@@ -68,7 +73,7 @@ void Tanker::set_unload_destination(shared_ptr<Island> unload_island) {
     unload_destination = unload_island;
     if (load_destination == unload_destination)
         throw Error(load_unload_the_same_c);
-    cout << get_name() << " will unload at " << unload_island->get_name() << endl;
+    SIM_LOG(info, cargo) << get_name() << " will unload at " << unload_island->get_name() << endl;
     start_cycle_if_ready();
 }
 
@@ -121,7 +126,7 @@ void Tanker::stop() {
     load_destination = nullptr;
     unload_destination = nullptr;
     tanker_state = Tanker_state::no_cargo_destinations;
-    cout << get_name() <<  " now has no cargo destinations" << endl;
+    SIM_LOG(info, cargo) << get_name() <<  " now has no cargo destinations" << endl;
 }
 
 // Perform Tanker-specific behavior after ship update.
@@ -131,7 +136,7 @@ void Tanker::update() {
         tanker_state = Tanker_state::no_cargo_destinations;
         load_destination = nullptr;
         unload_destination = nullptr;
-        cout << get_name() << " now has no cargo destinations" << endl;
+        SIM_LOG(info, cargo) << get_name() << " now has no cargo destinations" << endl;
     } else if (tanker_state == Tanker_state::moving_to_loading) {
         if (!is_moving() && can_dock(load_destination)) {
             dock(load_destination);
@@ -151,7 +156,7 @@ void Tanker::update() {
             tanker_state = Tanker_state::moving_to_unloading;
         } else {
             cargo += load_destination->provide_fuel(cargo_needed);
-            cout << get_name() << " now has " << cargo << " of cargo" << endl;
+            SIM_LOG(detail, cargo) << get_name() << " now has " << cargo << " of cargo" << endl;
         }
     } else if (tanker_state == Tanker_state::unloading) {
         if (cargo == 0.) {
@@ -166,19 +171,19 @@ void Tanker::update() {
 
 // Perform Tanker-specific behavior in addition to ship describe
 void Tanker::describe() const {
-    cout << "\nTanker ";
+    out << "\nTanker ";
     Ship::describe();
-    cout << "Cargo: " << cargo << " tons";
+    out << "Cargo: " << cargo << " tons";
     if (tanker_state == Tanker_state::no_cargo_destinations)
-        cout << ", no cargo destinations" << endl;
+        out << ", no cargo destinations" << endl;
     else if (tanker_state == Tanker_state::loading)
-        cout << ", loading" << endl;
+        out << ", loading" << endl;
     else if (tanker_state == Tanker_state::unloading)
-        cout << ", unloading" << endl;
+        out << ", unloading" << endl;
     else if (tanker_state == Tanker_state::moving_to_loading)
-        cout << ", moving to loading destination" << endl;
+        out << ", moving to loading destination" << endl;
     else if (tanker_state == Tanker_state::moving_to_unloading)
-        cout << ", moving to unloading destination" << endl;
+        out << ", moving to unloading destination" << endl;
 }
 
 void Tanker::save(std::ostream & os) const{
@@ -207,7 +212,7 @@ Tanker& Tanker::operator= (const Tanker& in_tanker) {
     return *this;
 }
 
-
-
-
-
+// the ship is idle only when it is not on a cargo run
+bool Tanker::is_idle() const {
+    return Ship::is_idle() && tanker_state == Tanker_state::no_cargo_destinations;
+}
@@ -43,9 +43,13 @@ public:
 	// perform Tanker-specific behavior
 	void update() override;
 	void describe() const override;
+	std::string get_type() const override;
     void save(std::ostream&) const override;
     Tanker& operator= (const Tanker&);
 private:
+    // the ship is idle only when it is not on a cargo run
+    bool is_idle() const override;
+    
     double cargo;
     double cargo_capacity;
     Tanker_state tanker_state;
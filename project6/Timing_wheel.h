@@ -0,0 +1,126 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/* Timing_wheel holds items that are due at future times, and hands them out as time
+ goes on, one tick at a time. It is a hierarchical wheel: each of its levels has a
+ slot for each value of one byte of the time. An item goes into the slot for its time
+ on the lowest level where its time and the current time differ only in that byte
+ and below, so the items on level 0 are due within the next 256 ticks. When the time
+ crosses into a new slot of a higher level, the items in that slot are moved down.
+
+ Scheduling an item and handing it out are both constant time, apart from moving it
+ down, which happens at most once per level; the cost does not depend on how many
+ items are waiting. Items due at the same time are handed out in the order they were
+ scheduled. Times are non-negative ints.
+ */
+
+template <typename T>
+class Timing_wheel {
+public:
+    explicit Timing_wheel(int now_ = 0) : now(now_) {}
+
+    int get_time() const { return now; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // discard every item, and start again at time now_
+    void clear(int now_);
+
+    // add an item due at time, which must be later than the current time
+    void insert(int time, T item);
+
+    /* Move on to the next tick, and call func(item) for each item due then, in the
+     order they were scheduled. func may schedule more items. */
+    template <typename F>
+    void advance(F func);
+
+    /* Call func(time, item) for each item, in the order they will be handed out: by
+     time, and those due at the same time in the order they were scheduled. */
+    template <typename F>
+    void for_each(F func) const;
+
+private:
+    static const int bits_c = 8;
+    static const int slots_c = 1 << bits_c;
+    static const int levels_c = 4;      // enough for every non-negative int
+    using Slot = std::vector<std::pair<int, T>>;
+
+    int now;
+    int count = 0;
+    Slot slots[levels_c][slots_c];
+
+    // put an item in the slot where it belongs at the current time
+    void place(int time, T&& item);
+};
+
+template <typename T>
+void Timing_wheel<T>::clear(int now_) {
+    for (auto& level : slots)
+        for (auto& slot : level)
+            slot.clear();
+    now = now_;
+    count = 0;
+}
+
+template <typename T>
+void Timing_wheel<T>::insert(int time, T item) {
+    place(time, std::move(item));
+    ++count;
+}
+
+template <typename T>
+template <typename F>
+void Timing_wheel<T>::advance(F func) {
+    ++now;
+    // the slots the time has just entered move down, the highest first, so that
+    // the items they hold end up on level 0 before level 0 is looked at
+    int level = 1;
+    while (level < levels_c && (now & ((1 << (bits_c * level)) - 1)) == 0)
+        ++level;
+    for (--level; level > 0; --level) {
+        Slot moving;
+        moving.swap(slots[level][(now >> (bits_c * level)) & (slots_c - 1)]);
+        for (auto& entry : moving)
+            place(entry.first, std::move(entry.second));
+    }
+    Slot due;
+    due.swap(slots[0][now & (slots_c - 1)]);
+    count -= int(due.size());
+    for (auto& entry : due)
+        func(entry.second);
+}
+
+template <typename T>
+template <typename F>
+void Timing_wheel<T>::for_each(F func) const {
+    // of the items due at the same time, those on a higher level were scheduled first,
+    // and are handed out first, as they are moved down before the others are scheduled
+    std::vector<const std::pair<int, T>*> entries;
+    entries.reserve(count);
+    for (int level = levels_c - 1; level >= 0; --level)
+        for (const auto& slot : slots[level])
+            for (const auto& entry : slot)
+                entries.push_back(&entry);
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const std::pair<int, T>* entry1, const std::pair<int, T>* entry2) {
+                         return entry1->first < entry2->first;
+                     });
+    for (const auto* entry : entries)
+        func(entry->first, entry->second);
+}
+
+template <typename T>
+void Timing_wheel<T>::place(int time, T&& item) {
+    // the level is that of the highest byte in which time and now differ
+    unsigned difference = unsigned(time ^ now);
+    int level = 0;
+    while (level < levels_c - 1 && (difference >> (bits_c * (level + 1))) != 0)
+        ++level;
+    slots[level][(time >> (bits_c * level)) & (slots_c - 1)].emplace_back(time, std::move(item));
+}
+
+#endif
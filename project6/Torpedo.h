@@ -9,6 +9,7 @@ public:
     Torpedo_boat(const std::string& name_, Point position_);
     Torpedo_boat(std::istream&);
     void describe() const override;
+    std::string get_type() const override;
     
     // Will escape after received hit
     void receive_hit(int hit_force, std::shared_ptr<Ship> attacker_ptr) override;
@@ -16,6 +17,8 @@ public:
     void save(std::ostream &) const override;
 private:
     void target_out_of_range(std::shared_ptr<Ship> target) override;
+    bool pursues_targets() const override
+    { return true; }
     std::shared_ptr<Island> find_refuge_island(std::shared_ptr<Ship> attacker);
 };
 
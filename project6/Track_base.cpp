@@ -3,17 +3,29 @@
 
 #include <iostream>
 #include <cmath>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
 /* Public Function Definitions */
 
-Track_base::Track_base() : altitude(0.){}
+Track_base::Track_base() : altitude(0.)
+{
+	update_heading();
+}
 
-Track_base::Track_base(Point position_) : position(position_), altitude(0.) {}
+Track_base::Track_base(Point position_) : position(position_), altitude(0.)
+{
+	update_heading();
+}
 
 Track_base::Track_base(Point position_, Course_speed course_speed_, double altitude_) :
-position(position_), course_speed(course_speed_), altitude(altitude_) {}
+position(position_), course_speed(course_speed_), altitude(altitude_)
+{
+	update_heading();
+}
 
 
 // range and bearing of this track from a specified position
@@ -61,8 +73,52 @@ bool Track_base::is_inbound_toward(const Track_base * track_ptr) const
 }
 
 // update the position of this object
+// the distance is scaled by the cached heading, which is the same arithmetic
+// as adding the Compass_vector (course_speed * time_increment) to the position
 void Track_base::update_position(double time_increment)
 {
-	position = position + (course_speed * time_increment);
+	double distance = course_speed.speed * time_increment;
+	position = position + Cartesian_vector(distance * heading.delta_x, distance * heading.delta_y);
+}
+
+// recompute the unit vector along the course
+void Track_base::update_heading()
+{
+	Point tip = Point() + Compass_vector(course_speed.course, 1.);
+	heading = Cartesian_vector(tip.x, tip.y);
+}
+
+/* Advance arrays of tracks by the same time increment.
+The vector code does the same multiplies and adds in the same order as the
+scalar code, with no fused multiply-add, so the results are identical.
+*/
+void advance_tracks(double* x, double* y, const double* heading_x, const double* heading_y,
+	const double* speed, int n, double time_increment)
+{
+	int i = 0;
+#if defined(__AVX__)
+	__m256d time4 = _mm256_set1_pd(time_increment);
+	for (; i + 4 <= n; i += 4) {
+		__m256d distance = _mm256_mul_pd(_mm256_loadu_pd(speed + i), time4);
+		__m256d dx = _mm256_mul_pd(distance, _mm256_loadu_pd(heading_x + i));
+		__m256d dy = _mm256_mul_pd(distance, _mm256_loadu_pd(heading_y + i));
+		_mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_loadu_pd(x + i), dx));
+		_mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), dy));
+	}
+#elif defined(__SSE2__)
+	__m128d time2 = _mm_set1_pd(time_increment);
+	for (; i + 2 <= n; i += 2) {
+		__m128d distance = _mm_mul_pd(_mm_loadu_pd(speed + i), time2);
+		__m128d dx = _mm_mul_pd(distance, _mm_loadu_pd(heading_x + i));
+		__m128d dy = _mm_mul_pd(distance, _mm_loadu_pd(heading_y + i));
+		_mm_storeu_pd(x + i, _mm_add_pd(_mm_loadu_pd(x + i), dx));
+		_mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), dy));
+	}
+#endif
+	for (; i < n; ++i) {
+		double distance = speed[i] * time_increment;
+		x[i] = x[i] + distance * heading_x[i];
+		y[i] = y[i] + distance * heading_y[i];
+	}
 }
 
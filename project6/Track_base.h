@@ -6,6 +6,9 @@ as a function of their Course_speed.
 
 Various values can be calculated for this track's position or motion as viewed from
 some other track.
+
+The unit vector along the course is kept in Cartesian form and is only recomputed
+when the course changes, so moving a track does not need any trigonometry.
 */
 
 #ifndef TRACK_BASE_H
@@ -32,14 +35,20 @@ public:
 		{return course_speed.speed;}
 	double get_altitude() const
 		{return altitude;}
+	// unit vector along the course
+	Cartesian_vector get_heading() const
+		{return heading;}
+	// displacement per unit time
+	Cartesian_vector get_velocity() const
+		{return heading * course_speed.speed;}
 			
 	// Writers
 	void set_position(Point position_)
 		{position = position_;}
 	void set_course_speed(const Course_speed& course_speed_)
-		{course_speed = course_speed_;}
+		{course_speed = course_speed_; update_heading();}
 	void set_course (double course_)
-		{course_speed.course = course_;}
+		{course_speed.course = course_; update_heading();}
 	void set_speed (double speed_)
 		{course_speed.speed = speed_;}
 	void set_altitude (double altitude_)
@@ -70,6 +79,19 @@ private:
 	Point position;				// Current location
 	Course_speed course_speed;			// Current course & speed
 	double altitude;					// Current altitude
+	Cartesian_vector heading;			// unit vector along the current course
+	
+	void update_heading();
 };
 
+/* Advance n tracks whose positions, unit headings, and speeds are kept in separate
+arrays by the same time increment. The positions come out exactly as update_position
+would compute them. Uses AVX or SSE2 when the compiler targets them, scalar code otherwise;
+the Makefile builds the AVX path with SIMD_FLAGS=-mavx2.
+Only geometry_bench uses it: ships move one at a time in Ship::update, each checking
+its fuel and destination as it goes, and keep their tracks in Track_base objects.
+*/
+void advance_tracks(double* x, double* y, const double* heading_x, const double* heading_y,
+	const double* speed, int n, double time_increment);
+
 #endif
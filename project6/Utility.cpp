@@ -2,6 +2,7 @@
 #include "iostream"
 #include "Geometry.h"
 #include "Model.h"
+#include "Ship_factory.h"
 
 int read_int(std::istream& is) {
     int int_;
@@ -38,6 +39,16 @@ std::shared_ptr<Island> read_island_ptr(std::istream& is) {
 }
 
 
+std::shared_ptr<Ship> read_ship_ptr(std::istream& is) {
+    std::string ship_type, ship_name;
+    is >> ship_type >> ship_name;
+    if (Model::get_instance().is_ship_present(ship_name))
+        return Model::get_instance().get_ship_ptr(ship_name);
+    std::shared_ptr<Ship> ship_ptr = create_ship(ship_name, ship_type, Point(0, 0));
+    Model::get_instance().add_ship(ship_ptr);
+    return ship_ptr;
+}
+
 std::string read_string(std::istream& is) {
     std::string str;
     is >> str;
@@ -1,11 +1,12 @@
 #ifndef UTILITY_H
 #define UTILITY_H
 
+#include "Geometry_fwd.h"
 #include <exception>
 #include <iosfwd>
 #include <memory>
-struct Point;
 class Island;
+class Ship;
 
 // This Exception class is used for general error
 class Error : public std::exception {
@@ -34,6 +35,10 @@ Point read_point(std::istream& is);
 
 std::shared_ptr<Island> read_island_ptr(std::istream&);
 
+/* read in a ship's type and name, and return the ship; one that has not been restored
+ yet is added in its place, and takes on its own record when that is read */
+std::shared_ptr<Ship> read_ship_ptr(std::istream&);
+
 
 std::string read_string(std::istream&);
 
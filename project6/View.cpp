@@ -1 +1,24 @@
-#include "View.h"
\ No newline at end of file
+#include "View.h"
+
+#include <string>
+#include <vector>
+
+using std::vector;
+
+/* Save the state of many objects at once, such as the snapshot sent when
+ the view is attached. By default each state goes through the update functions. */
+void View::update_states(const vector<Object_state>& states) {
+    for (const auto& state : states) {
+        if (!state.is_ship) {
+            update_location(state.name, state.location);
+            update_island_fuel(state.name, state.fuel);
+            continue;
+        }
+        update_ship_state(state.name, state.type, state.ship_state);
+        update_attacking(state.name, state.attacking);
+        update_location(state.name, state.location);
+        update_fuel(state.name, state.fuel);
+        update_course(state.name, state.course);
+        update_speed(state.name, state.speed);
+    }
+}
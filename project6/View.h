@@ -5,13 +5,28 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <iosfwd>
 
 /* *** View class ***
  View class is the base class for all other view classes.
  */
 
-struct Point;
+enum class Ship_state;
+
+/* The state of a Sim_object as it is sent to the views in bulk.
+ Islands only have a location and fuel; the other fields are used only for ships. */
+struct Object_state {
+    std::string name;
+    Point location;
+    bool is_ship = false;
+    double fuel = 0.;
+    double course = 0.;
+    double speed = 0.;
+    std::string type;
+    Ship_state ship_state{};
+    bool attacking = false;
+};
 
 class View {
 public:
@@ -31,6 +46,20 @@ public:
     
     // Save the supplied name and speed for future use in a draw() call
     virtual void update_speed(const std::string& name, double speed) {}
+    
+    // Save the supplied ship's kind and state for future use in a draw() call
+    virtual void update_ship_state(const std::string& name, const std::string& type,
+                                   Ship_state state) {}
+    
+    // Save whether the supplied ship is attacking for future use in a draw() call
+    virtual void update_attacking(const std::string& name, bool attacking) {}
+    
+    // Save the supplied island name and fuel for future use in a draw() call
+    virtual void update_island_fuel(const std::string& name, double fuel) {}
+    
+    /* Save the state of many objects at once, such as the snapshot sent when
+     the view is attached. By default each state goes through the update functions above. */
+    virtual void update_states(const std::vector<Object_state>& states);
 	
 	// prints out the current map
 	virtual void draw() const = 0;
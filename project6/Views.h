@@ -8,7 +8,6 @@
 #include <string>
 #include <iosfwd>
 
-struct Point;
 
 /* ********************** Grid View Interface *********************
  ****************************************************************** */
@@ -2,11 +2,13 @@
 #include "Utility.h"
 #include "Model.h"
 #include "Ship_factory.h"
+#include "Output.h"
+#include "Log.h"
 #include <iostream>
 #include <memory>
 #include <cassert>
+#include <algorithm>
 
-using std::cout;
 using std::endl;
 using std::shared_ptr;
 
@@ -30,17 +32,20 @@ Warships::Warships(std::istream& is): Ship(is), firepower(read_double(is)), max_
             Model::get_instance().add_ship(ship_ptr);
         }
     }
+    patrol_radius = read_double(is);
 }
 
 void Warships::describe() const {
     Ship::describe();
+    if (is_patrolling())
+        out << "Patrolling within " << patrol_radius << " nm" << endl;
     if (!attacking)
         return;
     if (target.expired()) {
-        cout << "Attacking absent ship" << endl;
+        out << "Attacking absent ship" << endl;
     } else {
         assert(target.lock()->is_afloat());
-        cout << "Attacking " << target.lock()->get_name() << endl;
+        out << "Attacking " << target.lock()->get_name() << endl;
     }
 }
 
@@ -54,7 +59,8 @@ void Warships::attack(shared_ptr<Ship> target_ptr_) {
         throw Error("Already attacking this target!");
     target = target_ptr_;
     attacking = true;
-    cout << get_name() << " will attack " << target.lock()->get_name() << endl;
+    Model::get_instance().notify_attacking(get_name(), attacking);
+    SIM_LOG(info, combat) << get_name() << " will attack " << target.lock()->get_name() << endl;
 }
 
 // stop attacking and discard the target pointer
@@ -62,12 +68,42 @@ void Warships::stop_attack() {
     if (!attacking)
         throw Error("Was not attacking!");
     attacking = false;
+    Model::get_instance().notify_attacking(get_name(), attacking);
     target.reset();
-    cout << get_name() << " stopping attack" << endl;
+    SIM_LOG(info, combat) << get_name() << " stopping attack" << endl;
+}
+
+// attack the nearest hostile ship within radius whenever not attacking another
+void Warships::patrol(double radius) {
+    if (!is_afloat())
+        throw Error("Cannot patrol!");
+    if (radius < 0.)
+        throw Error("Radius must not be negative!");
+    if (radius == 0.) {
+        if (is_patrolling()) {
+            SIM_LOG(info, combat) << get_name() << " ending patrol" << endl;
+        }
+        patrol_radius = 0.;
+        return;
+    }
+    if (get_side().empty())
+        throw Error("Ship has no side!");
+    patrol_radius = radius;
+    SIM_LOG(info, combat) << get_name() << " will patrol within " << patrol_radius << " nm" << endl;
+}
+
+// A ship that does not pursue only takes targets it can fire at.
+void Warships::acquire_target() {
+    double reach = pursues_targets() ? patrol_radius : std::min(patrol_radius, max_attack_range);
+    shared_ptr<Ship> hostile = Model::get_instance().find_nearest_hostile(*this, reach);
+    if (hostile)
+        attack(hostile);
 }
 
 void Warships::update() {
     Ship::update();
+    if (is_patrolling() && !attacking && is_afloat())
+        acquire_target();
     if (!attacking)
         return;
     
@@ -75,10 +111,13 @@ void Warships::update() {
     if (!target_ptr) {
         stop_attack();
     } else {
-        cout << get_name() << " is attacking" << endl;
+        SIM_LOG(detail, combat) << get_name() << " is attacking" << endl;
         if (cartesian_distance(get_location(), target_ptr->get_location()) <= max_attack_range) {
-            cout << get_name() << " fires" << endl;
-            target_ptr->receive_hit(firepower, shared_from_this());
+            SIM_LOG(detail, combat) << get_name() << " fires" << endl;
+            if (Model::get_instance().is_batched_combat())
+                Model::get_instance().record_hit(target_ptr, firepower, shared_from_this());
+            else
+                target_ptr->receive_hit(firepower, shared_from_this());
         } else {
             target_out_of_range(target_ptr);
         }
@@ -95,6 +134,7 @@ void Warships::save(std::ostream& os) const {
         os << "target " << typeid(*target.lock()).name()
         <<" "<<target.lock()->get_name() << endl;
     }
+    os << patrol_radius << endl;
 }
 
 Warships& Warships::operator= (const Warships& in_warship) {
@@ -103,5 +143,6 @@ Warships& Warships::operator= (const Warships& in_warship) {
     max_attack_range = in_warship.max_attack_range;
     target = in_warship.target;
     attacking = in_warship.attacking;
+    patrol_radius = in_warship.patrol_radius;
     return *this;
 }
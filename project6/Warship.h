@@ -21,20 +21,36 @@ public:
     // stop attacking and discard target pointer
     void stop_attack() override;
     
+    /* attack the nearest hostile ship within radius whenever not attacking another,
+     or stop doing so if radius is 0; the ship must take a side */
+    void patrol(double radius) override;
+    
     void save(std::ostream&) const override;
     
+    bool is_attacking() const override
+    { return attacking; }
+    
     virtual Warships& operator= (const Warships&);
 protected:
     virtual void target_out_of_range(std::shared_ptr<Ship> target) = 0;
     
-    bool is_attacking()
-    { return attacking; }
+    // Return true if the ship goes after a target that is out of range, so that
+    // on patrol it can take targets that are beyond its attack range
+    virtual bool pursues_targets() const
+    { return false; }
+    
+    bool is_patrolling() const
+    { return patrol_radius > 0.; }
     
 private:
     double firepower;
     double max_attack_range;
     std::weak_ptr<Ship> target;
     bool attacking = false;
+    double patrol_radius = 0.;
+    
+    // attack the nearest hostile ship it can take, if there is one
+    void acquire_target();
     
 };
 